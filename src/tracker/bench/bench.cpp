@@ -0,0 +1,450 @@
+/**
+ * Benchmark of Listing, Sorting and Searching
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "os.hpp"
+#include "file_system.hpp"
+#include "type_table.h"
+#include "item.h"
+#include "item_list.h"
+#include "listing_arena.h"
+#include "directory_lister.h"
+#include "subtree_searcher.h"
+#include "path_index.h"
+#include "size_calculator.h"
+#include "folder_sizer.h"
+#include "shortcut.hpp"
+#include "listing_cache.h"
+#include "sort_engine.hpp"
+#include "matcher.h"
+#include "migemo_engine.h"
+#include "search.h"
+
+namespace {
+
+	using clock_type = std::chrono::steady_clock;
+
+	struct Entry {
+		std::wstring name;
+		uint32_t     attr;
+		uint64_t     size;
+		uint64_t     time;
+	};
+
+	double elapsed_ms(clock_type::time_point t) {
+		return std::chrono::duration<double, std::milli>(clock_type::now() - t).count();
+	}
+
+	void report(const char* label, size_t n, double ms) {
+		std::printf("%-24s %10zu %12.3f ms\n", label, n, ms);
+	}
+
+	// Make file names looking like those of ordinary folders
+	std::vector<Entry> make_entries(size_t n) {
+		static const wchar_t* stems[] = { L"IMG_", L"report", L"Document ", L"track", L"data-", L"README", L"note", L"backup_" };
+		static const wchar_t* exts[]  = { L".jpg", L".txt", L".docx", L".mp3", L".csv", L"", L".md", L".zip" };
+
+		std::mt19937_64 rng(42);
+		std::vector<Entry> es;
+		es.reserve(n);
+		for (size_t i = 0; i < n; ++i) {
+			const auto r = rng();
+			const bool dir = (r % 10) == 0;
+			std::wstring name{ stems[r % 8] };
+			name.append(std::to_wstring((r >> 8) % 100000));
+			if (!dir) name.append(exts[(r >> 32) % 8]);
+			es.push_back({ name, dir ? os::ATTR_DIRECTORY : 0, dir ? 0 : (r >> 20) % (1ULL << 32), os::EPOCH_DIFF_TICKS + (r >> 4) });
+		}
+		return es;
+	}
+
+	// Read entries of a real directory
+	std::vector<Entry> read_entries(const std::wstring& dir) {
+		std::vector<Entry> es;
+		file_system::find_first_file(dir, [&](const std::wstring&, const os::FindData& fd) {
+			es.push_back({ std::wstring{ fd.name }, fd.attr, fd.size, fd.time });
+			return true;
+		});
+		return es;
+	}
+
+	void fill(ItemList& il, const std::vector<Entry>& es, const TypeTable& exts) {
+		auto& snap = il.snapshot();
+		snap.set_parent(L"/bench/");
+		for (const auto& e : es) {
+			il.add(snap.add_file(os::FindData{ e.name, e.attr, e.size, e.time }, exts));
+		}
+	}
+
+	// Best of three runs of sorting a copy of rows
+	template<typename F> double time_sort(const std::vector<uint32_t>& rows, F fn) {
+		double best = 0;
+		for (int i = 0; i < 3; ++i) {
+			auto rs = rows;
+			const auto t = clock_type::now();
+			fn(rs);
+			const auto ms = elapsed_ms(t);
+			if (i == 0 || ms < best) best = ms;
+		}
+		return best;
+	}
+
+	// Compare the sort engine with std::sort at growing sizes to find the crossovers
+	void crossover(const TypeTable& exts) {
+		std::printf("%-10s %12s %12s %12s %12s  (threads: %zu)\n", "n", "date sort", "date radix", "name sort", "name par", sort_engine::thread_count());
+		for (size_t n = 128; n <= 262144; n *= 2) {
+			const auto es = make_entries(n);
+			DirectorySnapshot snap;
+			snap.set_parent(L"/bench/");
+			for (const auto& e : es) snap.add_file(os::FindData{ e.name, e.attr, e.size, e.time }, exts);
+			snap.prepare_keys();
+			std::vector<uint32_t> rows(n);
+			std::iota(rows.begin(), rows.end(), uint32_t{ 0 });
+
+			const CompByDate by_date(snap, false);
+			const CompByName by_name(snap, false);
+			std::printf("%-10zu %12.3f %12.3f %12.3f %12.3f\n", n,
+				time_sort(rows, [&](auto& rs) { std::sort(rs.begin(), rs.end(), by_date); }),
+				time_sort(rows, [&](auto& rs) { sort_engine::radix_sort(rs, [&](uint32_t r) { return by_date.radix_key(r); }); }),
+				time_sort(rows, [&](auto& rs) { std::sort(rs.begin(), rs.end(), by_name); }),
+				time_sort(rows, [&](auto& rs) { sort_engine::parallel_sort(rs, by_name, (std::max)(sort_engine::thread_count(), size_t{ 2 })); }));
+		}
+	}
+
+}
+
+int main(int argc, char* argv[]) {
+	size_t n = 100000;
+	std::wstring dir, dict, links;
+	for (int i = 1; i < argc; ++i) {
+		const std::string a{ argv[i] };
+		if (a == "--n" && i + 1 < argc) n = std::strtoull(argv[++i], nullptr, 10);
+		else if (a == "--dir" && i + 1 < argc) dir = os::from_utf8(argv[++i]);
+		else if (a == "--dict" && i + 1 < argc) dict = os::from_utf8(argv[++i]);
+		else if (a == "--links" && i + 1 < argc) links = os::from_utf8(argv[++i]);
+		else if (a == "--crossover") {
+			crossover(TypeTable{});
+			return 0;
+		} else {
+			std::fprintf(stderr, "usage: %s [--n count] [--dir path] [--dict path] [--links path] [--crossover]\n", argv[0]);
+			return 1;
+		}
+	}
+	// Shortcuts in the folder: targets read from the files directly, and by the shell on Windows
+	if (!links.empty()) {
+		std::vector<std::wstring> ps;
+		file_system::find_first_file(links, [&](const std::wstring& parent, const os::FindData& fd) {
+			if (fd.name.ends_with(L".lnk")) ps.push_back(std::wstring{ parent }.append(fd.name));
+			return true;
+		});
+		const auto resolve_all = [&](const char* label, std::wstring (*fn)(const std::wstring&)) {
+			size_t resolved = 0;
+			const auto t = clock_type::now();
+			for (const auto& p : ps) resolved += fn(p).empty() ? 0 : 1;
+			std::printf("%-24s %10zu %12.3f ms  (%zu links)\n", label, resolved, elapsed_ms(t), ps.size());
+		};
+		resolve_all("link parse", shell_link::target);
+#ifdef _WIN32
+		const auto res = ::CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+		resolve_all("link shell", shortcut::resolve_by_shell);
+		if (SUCCEEDED(res)) ::CoUninitialize();
+#endif
+	}
+	if (!dir.empty()) {
+		auto t = clock_type::now();
+		const auto es = read_entries(dir);
+		report("enumerate", es.size(), elapsed_ms(t));
+		if (es.empty()) return 1;
+
+		// Background listing: time until the first batch and until the end
+		DirectoryLister lister;
+		DirectoryLister::Batch batch;
+		t = clock_type::now();
+		lister.start(dir);
+		lister.wait_first_batch(10000);
+		bool done = lister.take(batch);
+		size_t listed = batch.size();
+		report("list first batch", listed, elapsed_ms(t));
+		while (!done) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			done = lister.take(batch);
+			listed += batch.size();
+		}
+		report("list all", listed, elapsed_ms(t));
+
+		// Searching the files below the folder, by one worker and by all
+		SubtreeSearcher searcher;
+		for (const size_t threads : { size_t{ 1 }, sort_engine::thread_count() }) {
+			t = clock_type::now();
+			searcher.start(dir, [](Matcher& m) { m.set_literal(L"e"); }, threads);
+			size_t found = 0;
+			double first = -1;
+			for (bool end = false; !end; ) {
+				end = searcher.take(batch);
+				if (batch.size() && first < 0) first = elapsed_ms(t);
+				found += batch.size();
+				if (!end) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			const double all = elapsed_ms(t);
+			std::printf("%-24s %10zu %12.3f ms  (first hit %.3f ms, %zu threads)\n", "subtree search", found, all, first, threads);
+		}
+
+		// Total size of the folder within the budget of the information popup, walked recursively and by the
+		// workers, and then with the sizes cached (1 when done)
+		{
+			uint64_t size{};
+			t = clock_type::now();
+			const bool ok = file_system::calc_file_size(dir, size, os::tick_count() + 1000);
+			std::printf("%-24s %10d %12.3f ms  (%llu B)\n", "size recursive", ok, elapsed_ms(t), static_cast<unsigned long long>(size));
+			SizeCalculator calc;
+			for (const auto* label : { "size parallel", "size cached" }) {
+				if (label[5] == 'p') SizeCache::shared().clear();
+				t = clock_type::now();
+				const bool done = calc.calc({ dir }, size, os::tick_count() + 1000);
+				std::printf("%-24s %10d %12.3f ms  (%llu B, %zu threads)\n", label, done, elapsed_ms(t), static_cast<unsigned long long>(size), sort_engine::thread_count());
+			}
+		}
+
+		// Trigram index of the names below the folder: full build, rebuild of the unchanged folders, loading, and lookups
+		const auto file = (std::filesystem::temp_directory_path() / "tracker_bench_index.dat").wstring();
+		std::filesystem::remove(file);
+		const auto wait = [](PathIndex& idx) {
+			while (idx.is_building()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		};
+		{
+			PathIndex idx;
+			t = clock_type::now();
+			idx.start(file, { dir });
+			wait(idx);
+			report("index build", idx.size(), elapsed_ms(t));
+			uint64_t bytes{};
+			os::file_size(file, bytes);
+			std::printf("%-24s %10zu %12llu B   (%.1f B per name)\n", "index file", idx.size(), static_cast<unsigned long long>(bytes), idx.size() ? static_cast<double>(bytes) / idx.size() : 0.0);
+			t = clock_type::now();
+			idx.start(file, { dir });
+			wait(idx);
+			report("index rebuild", idx.size(), elapsed_ms(t));
+		}
+		PathIndex idx;
+		t = clock_type::now();
+		idx.start(file, { dir });
+		while (idx.size() == 0 && idx.is_building()) std::this_thread::sleep_for(std::chrono::microseconds(100));
+		report("index load", idx.size(), elapsed_ms(t));
+		wait(idx);
+		Matcher im;
+		for (const auto* w : { L"lib", L"config", L"python3", L"e" }) {
+			im.set_literal(w);
+			size_t hits = 0;
+			t = clock_type::now();
+			idx.query(im.literal(), [&](std::wstring_view name) { return im.match(name); }, SIZE_MAX, [&](const os::FindData&) { ++hits; });
+			std::printf("%-24s %10zu %12.3f ms  (\"%ls\")\n", "index query", hits, elapsed_ms(t), w);
+		}
+		std::filesystem::remove(file);
+	}
+	const auto es = dir.empty() ? make_entries(n) : read_entries(dir);
+	const TypeTable exts;
+	ItemList il;
+
+	auto t = clock_type::now();
+	fill(il, es, exts);
+	report("build", il.size(), elapsed_ms(t));
+
+	// Revisiting a folder through the cache, and invalidation by a change
+	if (!dir.empty()) {
+		ListingCache cache;
+		cache.watch(dir);
+		cache.put(dir, 0, il.release());
+		t = clock_type::now();
+		auto snap = cache.take(dir, 0);
+		report("cache hit", snap ? snap->size() : 0, elapsed_ms(t));
+		il.assign(std::move(*snap));
+		cache.put(dir, 0, il.release());
+
+		const std::filesystem::path touched{ os::native_path(dir + L"/.tracker_bench") };
+		std::ofstream{ touched }.put('x');
+		std::filesystem::remove(touched);
+		t = clock_type::now();
+		snap = cache.take(dir, 0);
+		report("cache after change", snap ? snap->size() : 0, elapsed_ms(t));
+		il.clear();
+		fill(il, es, exts);
+	}
+
+	static const char* sort_labels[] = { "sort name", "sort type", "sort date", "sort size" };
+	for (int by = 0; by < 4; ++by) {
+		for (int rev = 0; rev < 2; ++rev) {
+			il.clear();
+			fill(il, es, exts);
+			t = clock_type::now();
+			il.sort(by, rev != 0);
+			report(rev ? (std::string(sort_labels[by]) + " rev").c_str() : sort_labels[by], il.size(), elapsed_ms(t));
+		}
+	}
+
+	// Changing only the direction of the sort
+	il.sort(0, false);
+	t = clock_type::now();
+	il.sort(0, true);
+	report("resort name rev", il.size(), elapsed_ms(t));
+
+	// Sizes of folders arriving in a batch while sorted by sizes
+	il.sort(3, false);
+	FolderSizer::Sizes sizes;
+	for (size_t i = 0; i < 16; ++i) sizes.emplace_back(static_cast<uint32_t>(i * il.size() / 16), i * 1000003);
+	t = clock_type::now();
+	il.set_sizes(sizes);
+	report("folder sizes placed", sizes.size(), elapsed_ms(t));
+
+	Search search;
+	search.initialize(false);
+	for (const wchar_t c : std::wstring{ L"REP" }) search.key_search(c);
+	t = clock_type::now();
+	auto hit = search.find_first(std::nullopt, il);
+	size_t hits = 0;
+	for (; hit && hits < 100; ++hits) {
+		const auto next = search.find_next(hit, il);
+		if (!next || next.value() <= hit.value()) break;
+		hit = next;
+	}
+	report("search 100 hits", hits, elapsed_ms(t));
+
+	// Filtering as typing, each key narrowing the items shown by the previous one
+	Search filter;
+	filter.initialize(false, true);
+	for (const wchar_t c : std::wstring{ L"DOC" }) {
+		t = clock_type::now();
+		filter.filter_key(c);
+		il.filter([&](const Item& it) { return filter.match(it.name()); }, true);
+		report((std::string("filter key ") + static_cast<char>(c)).c_str(), il.size(), elapsed_ms(t));
+	}
+	filter.filter_back();
+	t = clock_type::now();
+	il.filter([&](const Item& it) { return filter.match(it.name()); }, false);
+	report("filter back", il.size(), elapsed_ms(t));
+	il.unfilter();
+
+	// Ranking by fuzzy matching as typing, each key narrowing the items ranked by the previous one
+	Search fuzzy;
+	fuzzy.initialize(false, true, true);
+	for (const wchar_t c : std::wstring{ L"DCX" }) {
+		t = clock_type::now();
+		fuzzy.filter_key(c);
+		il.rank([&](const Item& it) { return fuzzy.score(it.name(), it.char_mask()); }, true);
+		report((std::string("fuzzy key ") + static_cast<char>(c)).c_str(), il.size(), elapsed_ms(t));
+	}
+	il.unfilter();
+	std::vector<size_t> ranked;
+	fuzzy.clear_filter();
+	for (const wchar_t c : std::wstring{ L"RP9" }) fuzzy.filter_key(c);
+	t = clock_type::now();
+	fuzzy.rank(il, ranked);
+	report("fuzzy rank all", ranked.size(), elapsed_ms(t));
+
+	// Scanning all names by a pattern shaped like those of Migemo, compiled once
+	const std::wstring pat{ L"(rep(o|ort)|\u30ec\u30dd|[\u30ec\uff9a]\u30dd\u30fc\u30c8|back(up)?_9+|track[0-9]+\\.mp3)" };
+	std::wregex re{ pat, std::regex_constants::ECMAScript | std::regex_constants::icase };
+	t = clock_type::now();
+	size_t n_re = 0;
+	for (size_t i = 0; i < il.size(); ++i) {
+		const auto name = il.at(i).name();
+		if (std::regex_search(name.begin(), name.end(), re)) ++n_re;
+	}
+	report("scan wregex", n_re, elapsed_ms(t));
+	Matcher m;
+	m.set_pattern(pat);
+	t = clock_type::now();
+	size_t n_m = 0;
+	for (size_t i = 0; i < il.size(); ++i) {
+		if (m.match(il.at(i).name())) ++n_m;
+	}
+	report(m.is_automaton() ? "scan automaton" : "scan matcher", n_m, elapsed_ms(t));
+
+	// The same without loops is a finite set of words run by Aho-Corasick
+	const std::wstring words{ L"(rep(o|ort)|\u30ec\u30dd|[\u30ec\uff9a]\u30dd\u30fc\u30c8|back(up)?_9|track[0-9]\\.mp3)" };
+	m.set_pattern(words);
+	t = clock_type::now();
+	n_m = 0;
+	for (size_t i = 0; i < il.size(); ++i) {
+		if (m.match(il.at(i).name())) ++n_m;
+	}
+	report(m.is_words() ? "scan words" : "scan matcher", n_m, elapsed_ms(t));
+	m.set_literal(L"ReadMe");
+	t = clock_type::now();
+	n_m = 0;
+	for (size_t i = 0; i < il.size(); ++i) {
+		if (m.match(il.at(i).name())) ++n_m;
+	}
+	report("scan literal", n_m, elapsed_ms(t));
+
+	// Migemo: loading the dictionaries, expanding queries and scanning the names by the patterns
+	if (!dict.empty()) {
+		MigemoEngine migemo;
+		t = clock_type::now();
+		const bool loaded = migemo.load(dict);
+		report("migemo load", loaded ? 1 : 0, elapsed_ms(t));
+		if (loaded) {
+			std::wstring pattern;
+			for (const std::wstring w : { L"k", L"ka", L"kan", L"kanj", L"kanji", L"TOUKYOU", L"kanjiNyuuryoku" }) {
+				t = clock_type::now();
+				migemo.query(w, pattern);
+				const double q = elapsed_ms(t);
+				Matcher mp;
+				t = clock_type::now();
+				mp.set_pattern(pattern);
+				const double c = elapsed_ms(t);
+				t = clock_type::now();
+				size_t hit = 0;
+				for (size_t i = 0; i < il.size(); ++i) {
+					if (mp.match(il.at(i).name())) ++hit;
+				}
+				std::printf("%-24s %10zu %12.3f ms  (pattern %zu chars, compile %.3f ms%s, scan %.3f ms, %zu hits)\n",
+					("migemo " + os::to_utf8(w)).c_str(), pattern.size(), q, pattern.size(), c, mp.is_words() ? " as words" : "", elapsed_ms(t), hit);
+			}
+
+			// Typing a word key by key, extending the last expansion or expanding each query from scratch
+			const std::wstring typed = L"kanjinyuuryokuhouhou";
+			for (const bool scratch : { false, true }) {
+				migemo.query(L"", pattern);
+				t = clock_type::now();
+				size_t len = 0;
+				for (size_t i = 1; i <= typed.size(); ++i) {
+					if (scratch) migemo.query(L"", pattern);  // An empty query drops the state
+					migemo.query(typed.substr(0, i), pattern);
+					len += pattern.size();
+				}
+				report(scratch ? "migemo per key scratch" : "migemo per key", len, elapsed_ms(t));
+			}
+		}
+	}
+
+	// Memory kept after a huge listing is followed by small ones
+	ListingArena arena;
+	arena.record(il);
+	const size_t peak = il.footprint();
+	const std::vector<Entry> small(es.begin(), es.begin() + (std::min)(es.size(), size_t{ 100 }));
+	t = clock_type::now();
+	for (int i = 0; i < 16; ++i) {
+		arena.recycle(il);
+		fill(il, small, exts);
+		arena.record(il);
+	}
+	report("recycle x16", arena.trim_count(), elapsed_ms(t));
+	std::printf("%-24s %10zu -> %zu bytes\n", "footprint", peak, il.footprint());
+	return 0;
+}
@@ -2,7 +2,7 @@
  * Bookmarks
  *
  * @author Takuto Yanagida
- * @version 2026-04-30
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -10,6 +10,8 @@
 #include <vector>
 #include <string>
 
+#include "tracker.h"
+#include "path.hpp"
 #include "pref.hpp"
 #include "text_reader_writer.hpp"
 
@@ -24,7 +26,7 @@ public:
 
 	inline static const std::wstring PATH{ L":BOOKMARK" }, NAME{ L"Bookmark" };
 
-	Bookmark(const std::wstring& iniPath) noexcept : path_(path::parent(iniPath).append(L"\\").append(FILE_NAME)) {}
+	Bookmark(const std::wstring& iniPath) noexcept : path_(path::parent(iniPath).append(1, path::PATH_SEPARATOR).append(FILE_NAME)) {}
 
 	void restore(Pref& pref) {
 		paths_ = text_reader_writer::read(path_);
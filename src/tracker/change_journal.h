@@ -0,0 +1,295 @@
+/**
+ * Change Journal (Changes of the Folders below Root Folders)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cwchar>
+#include <cwctype>
+
+#include "os.hpp"
+#include "path.hpp"
+
+#ifdef _WIN32
+#include <winioctl.h>
+#else
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <climits>
+#endif
+
+class ChangeJournal {
+
+	std::vector<std::wstring> roots_;
+	std::vector<std::wstring> changed_;
+	bool lost_{};  // Whether changes may have been missed
+
+#ifdef _WIN32
+	// The change journal of the volume of a root, read from the position where the index was saved; the volume
+	// is opened only while it is read so that no handle keeps the volume from being ejected, and the folders
+	// of the volumes whose journals cannot be opened without the privilege are checked by their times instead
+	struct Source {
+		std::wstring volume;  // Like C:
+		HANDLE handle{ INVALID_HANDLE_VALUE };
+		uint64_t journal{};
+		int64_t next{};  // USN to read next
+		std::vector<DWORD> buf;
+	};
+
+	std::vector<std::unique_ptr<Source>> ss_;
+
+	static bool open_volume(Source& s) noexcept {
+		s.handle = ::CreateFile((L"\\\\.\\" + s.volume).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+		return s.handle != INVALID_HANDLE_VALUE;
+	}
+
+	static void close(Source& s) noexcept {
+		if (s.handle == INVALID_HANDLE_VALUE) return;
+		::CloseHandle(s.handle);
+		s.handle = INVALID_HANDLE_VALUE;
+	}
+
+	// Open the journal of the volume, continuing from the checkpoint when it is of the same journal and not
+	// yet overwritten (known is set to false when the changes since then are not known)
+	static bool open_journal(Source& s, const std::vector<std::wstring>& checkpoint, bool& known) {
+		if (!open_volume(s)) return false;
+		USN_JOURNAL_DATA_V0 jd{};
+		DWORD size{};
+		const bool ok = ::DeviceIoControl(s.handle, FSCTL_QUERY_USN_JOURNAL, nullptr, 0, &jd, sizeof(jd), &size, nullptr) != 0;
+		close(s);
+		if (!ok) return false;
+		s.journal = jd.UsnJournalID;
+		s.next    = jd.NextUsn;
+		for (const auto& line : checkpoint) {
+			const auto t1 = line.find(L'\t'), t2 = line.rfind(L'\t');
+			if (t1 == std::wstring::npos || t1 == t2 || line.substr(0, t1) != s.volume) continue;
+			const auto id  = std::wcstoull(line.c_str() + t1 + 1, nullptr, 10);
+			const auto usn = std::wcstoll(line.c_str() + t2 + 1, nullptr, 10);
+			if (id == s.journal && jd.FirstUsn <= usn && usn <= jd.NextUsn) {
+				s.next = usn;
+				return true;
+			}
+		}
+		known = false;
+		return true;
+	}
+
+	// Path of the folder by its file reference number
+	static std::wstring folder_path(const Source& s, uint64_t frn) {
+		FILE_ID_DESCRIPTOR fid{};
+		fid.dwSize = sizeof(fid);
+		fid.Type   = FileIdType;
+		fid.FileId.QuadPart = static_cast<LONGLONG>(frn);
+		const HANDLE h = ::OpenFileById(s.handle, &fid, 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, FILE_FLAG_BACKUP_SEMANTICS);
+		if (h == INVALID_HANDLE_VALUE) return {};  // Deleted
+		std::wstring ret(MAX_PATH, L'\0');
+		DWORD len = ::GetFinalPathNameByHandle(h, ret.data(), static_cast<DWORD>(ret.size()), FILE_NAME_NORMALIZED | VOLUME_NAME_DOS);
+		if (len >= ret.size()) {
+			ret.resize(len);
+			len = ::GetFinalPathNameByHandle(h, ret.data(), static_cast<DWORD>(ret.size()), FILE_NAME_NORMALIZED | VOLUME_NAME_DOS);
+		}
+		::CloseHandle(h);
+		ret.resize((len < ret.size()) ? len : 0);
+		if (ret.starts_with(L"\\\\?\\")) ret.erase(0, 4);
+		return ret;
+	}
+
+	void read_journal(Source& s) {
+		if (!open_volume(s)) {
+			lost_ = true;  // Such as ejected
+			return;
+		}
+		READ_USN_JOURNAL_DATA_V0 rd{};
+		rd.ReasonMask = USN_REASON_FILE_CREATE | USN_REASON_FILE_DELETE | USN_REASON_RENAME_OLD_NAME | USN_REASON_RENAME_NEW_NAME |
+			USN_REASON_DATA_OVERWRITE | USN_REASON_DATA_EXTEND | USN_REASON_DATA_TRUNCATION | USN_REASON_BASIC_INFO_CHANGE;
+		rd.ReturnOnlyOnClose = FALSE;
+		rd.UsnJournalID      = s.journal;
+		std::vector<uint64_t> frns;
+		while (true) {
+			rd.StartUsn = s.next;
+			DWORD size{};
+			if (!::DeviceIoControl(s.handle, FSCTL_READ_USN_JOURNAL, &rd, sizeof(rd), s.buf.data(), static_cast<DWORD>(s.buf.size() * sizeof(DWORD)), &size, nullptr)) {
+				lost_ = true;  // The journal has been deleted or overwritten
+				USN_JOURNAL_DATA_V0 jd{};
+				DWORD s2{};
+				if (::DeviceIoControl(s.handle, FSCTL_QUERY_USN_JOURNAL, nullptr, 0, &jd, sizeof(jd), &s2, nullptr)) {
+					s.journal = jd.UsnJournalID;
+					s.next    = jd.NextUsn;
+				}
+				break;
+			}
+			if (size <= sizeof(USN)) break;
+			const auto* b = reinterpret_cast<const char*>(s.buf.data());
+			s.next = *reinterpret_cast<const USN*>(b);
+			for (DWORD off = sizeof(USN); off + sizeof(USN_RECORD_V2) <= size; ) {
+				const auto* r = reinterpret_cast<const USN_RECORD_V2*>(b + off);
+				if (r->RecordLength == 0) break;
+				if (r->MajorVersion == 2) frns.push_back(r->ParentFileReferenceNumber);
+				off += r->RecordLength;
+			}
+		}
+		std::sort(frns.begin(), frns.end());
+		frns.erase(std::unique(frns.begin(), frns.end()), frns.end());
+		for (const auto frn : frns) add(folder_path(s, frn));
+		close(s);
+	}
+#else
+	int fd_{ -1 };
+	std::unordered_map<int, std::wstring> wds_;   // Folders watched
+	std::unordered_map<std::wstring, int> dirs_;
+#endif
+
+	// Record the folder when it is below a root
+	void add(const std::wstring& dir) {
+		if (dir.empty()) return;
+		const auto k = key(dir);
+		for (const auto& r : roots_) {
+			if (k.size() < r.size() || k.compare(0, r.size(), r) != 0) continue;
+			if (k.size() == r.size() || r.back() == path::PATH_SEPARATOR || k[r.size()] == path::PATH_SEPARATOR) {
+				changed_.push_back(dir);
+				return;
+			}
+		}
+	}
+
+public:
+
+	ChangeJournal() noexcept = default;
+	ChangeJournal(const ChangeJournal&) = delete;
+	ChangeJournal& operator=(const ChangeJournal&) = delete;
+	ChangeJournal(ChangeJournal&&) = delete;
+	ChangeJournal& operator=(ChangeJournal&&) = delete;
+
+	~ChangeJournal() {
+		close();
+	}
+
+	// Key of the folder to compare with those taken, ignoring case where the file system does
+	static std::wstring key(std::wstring_view path) {
+		std::wstring ret{ path };
+#ifdef _WIN32
+		for (auto& c : ret) c = static_cast<wchar_t>(std::towlower(c));
+#endif
+		return ret;
+	}
+
+	// Start recording the changes below the roots; the changes since the checkpoint are recorded first when
+	// the journal keeps them (returns true then, and false when the changes since the checkpoint are unknown)
+	bool open(const std::vector<std::wstring>& roots, const std::vector<std::wstring>& checkpoint) {
+		close();
+		for (const auto& r : roots) roots_.push_back(key(r));
+#ifdef _WIN32
+		bool known = !roots.empty();
+		for (const auto& r : roots) {
+			auto s = std::make_unique<Source>();
+			s->volume = (r.size() >= 2 && r[1] == L':') ? r.substr(0, 2) : std::wstring();
+			const auto it = std::find_if(ss_.begin(), ss_.end(), [&](const auto& o) { return o->volume == s->volume; });
+			if (!s->volume.empty() && it != ss_.end()) continue;  // Read with another root of the volume
+			s->buf.resize(16384);
+			if (s->volume.empty() || !open_journal(*s, checkpoint, known)) {
+				known = false;
+				lost_ = true;  // Such as network folders, or without the privilege
+				continue;
+			}
+			ss_.push_back(std::move(s));
+		}
+		return known;
+#else
+		fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (fd_ == -1) lost_ = true;
+		return false;  // Changes are not kept while not watched
+#endif
+	}
+
+	void close() {
+#ifdef _WIN32
+		for (auto& s : ss_) close(*s);
+		ss_.clear();
+#else
+		if (fd_ != -1) ::close(fd_);
+		fd_ = -1;
+		wds_.clear();
+		dirs_.clear();
+#endif
+		roots_.clear();
+		changed_.clear();
+		lost_ = false;
+	}
+
+	// Watch the folder before it is listed, where folders are watched one by one
+	void watch(const std::wstring& dir) {
+#ifndef _WIN32
+		if (fd_ == -1 || dirs_.contains(dir)) return;
+		const int wd = ::inotify_add_watch(fd_, os::to_utf8(dir).c_str(),
+			IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB | IN_CLOSE_WRITE | IN_ONLYDIR);
+		if (wd == -1) {
+			lost_ = true;  // Such as the limit of the watches
+			return;
+		}
+		if (const auto it = wds_.find(wd); it != wds_.end()) dirs_.erase(it->second);  // Renamed
+		wds_[wd]   = dir;
+		dirs_[dir] = wd;
+#else
+		static_cast<void>(dir);
+#endif
+	}
+
+	// Take the folders changed since the last call (returns false when changes may have been missed, even once
+	// since being opened, so that all the folders need to be checked)
+	bool take(std::vector<std::wstring>& dirs) {
+#ifdef _WIN32
+		for (auto& s : ss_) read_journal(*s);
+#else
+		if (fd_ != -1) {
+			alignas(inotify_event) char buf[sizeof(inotify_event) * 64 + NAME_MAX + 1];
+			while (true) {
+				const auto len = ::read(fd_, buf, sizeof(buf));
+				if (len <= 0) break;
+				for (ssize_t off = 0; off < len; ) {
+					const auto* e = reinterpret_cast<const inotify_event*>(buf + off);
+					off += sizeof(inotify_event) + e->len;
+					if (e->mask & IN_Q_OVERFLOW) {
+						lost_ = true;
+						continue;
+					}
+					const auto it = wds_.find(e->wd);
+					if (it == wds_.end()) continue;
+					if (e->mask & IN_IGNORED) {  // Deleted
+						dirs_.erase(it->second);
+						wds_.erase(it);
+						continue;
+					}
+					add(it->second);
+				}
+			}
+		}
+#endif
+		std::sort(changed_.begin(), changed_.end());
+		changed_.erase(std::unique(changed_.begin(), changed_.end()), changed_.end());
+		dirs.insert(dirs.end(), changed_.begin(), changed_.end());
+		changed_.clear();
+		return !lost_;
+	}
+
+	// Positions of the journals to continue from after the index is saved (empty where there is no journal)
+	std::vector<std::wstring> checkpoint() const {
+		std::vector<std::wstring> ret;
+#ifdef _WIN32
+		for (const auto& s : ss_) {
+			ret.push_back(s->volume + L'\t' + std::to_wstring(s->journal) + L'\t' + std::to_wstring(s->next));
+		}
+#endif
+		return ret;
+	}
+
+};
@@ -2,11 +2,10 @@
  * Classes
  *
  * @author Takuto Yanagida
- * @version 2025-11-19
+ * @version 2026-10-17
  */
 
 #pragma once
 
 class Pref;
 class ToolTip;
-class StringConverter;
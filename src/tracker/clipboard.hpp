@@ -2,7 +2,7 @@
  * Clipboard Operations
  *
  * @author Takuto Yanagida
- * @version 2025-11-09
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -16,7 +16,7 @@
 #include "gsl/gsl"
 
 #include "path.hpp"
-#include "link.hpp"
+#include "shortcut.hpp"
 #include "shell.hpp"
 
 namespace clipboard {
@@ -70,15 +70,15 @@ namespace clipboard {
 				if (buf.data() != nullptr && buf.front() != L'\0') {
 					std::wstring target{ buf.data() };
 					auto name = path::name(target);
-					if (link::is_link(target)) {
-						target = link::resolve(target);
+					if (shortcut::is_link(target)) {
+						target = shortcut::resolve(target);
 					} else {
 						name.append(L".lnk");
 					}
 					auto path{ dir };
 					path.append(L"\\").append(name);
 					auto shortcut = file_system::unique_name(path);
-					if (link::create(shortcut, target)) ret = true;
+					if (shortcut::create(shortcut, target)) ret = true;
 				}
 			}
 		}
@@ -0,0 +1,130 @@
+/**
+ * Natural-Order Collator (Sort Keys of the System on Windows, Compatible with StrCmpLogicalW Elsewhere)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cwctype>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace collator {
+
+	// Units of a key: 0 terminates, 1 starts a number, others are characters and digits shifted by 2
+	constexpr uint32_t KEY_END    = 0;
+	constexpr uint32_t KEY_NUMBER = 1;
+	constexpr uint32_t KEY_SHIFT  = 2;
+
+	// Value of a digit including full-width ones (-1 for non-digits)
+	inline int digit_value(wchar_t c) noexcept {
+		if (L'0' <= c && c <= L'9') return c - L'0';
+		if (0xFF10 <= c && c <= 0xFF19) return c - 0xFF10;
+		return -1;
+	}
+
+	inline uint32_t fold(wchar_t c) noexcept {
+		return static_cast<uint32_t>(std::towlower(c));
+	}
+
+#ifdef _WIN32
+	// Flags of the order of the shell, where case is ignored and digits are compared as numbers
+	constexpr DWORD SYSTEM_FLAGS = NORM_IGNORECASE | SORT_DIGITSASNUMBERS;
+
+	// Append the sort key of the system, packed by four bytes in big-endian so that the units compare as the
+	// bytes do (returns false when it cannot be made)
+	inline bool append_system_key(std::vector<uint32_t>& out, std::wstring_view s) {
+		if (s.empty()) {
+			out.push_back(KEY_END);
+			return true;
+		}
+		const int len = static_cast<int>(s.size());
+		const int size = ::LCMapStringEx(LOCALE_NAME_USER_DEFAULT, LCMAP_SORTKEY | SYSTEM_FLAGS, s.data(), len, nullptr, 0, nullptr, nullptr, 0);
+		if (size <= 0) return false;
+		thread_local std::vector<BYTE> buf;
+		buf.assign(static_cast<size_t>(size) + 3, 0);  // Padded by zeros, which are below any byte of keys
+		::LCMapStringEx(LOCALE_NAME_USER_DEFAULT, LCMAP_SORTKEY | SYSTEM_FLAGS, s.data(), len, reinterpret_cast<LPWSTR>(buf.data()), size, nullptr, nullptr, 0);
+		for (size_t i = 0; i + 3 < buf.size(); i += 4) {
+			const uint32_t u = (static_cast<uint32_t>(buf[i]) << 24) | (static_cast<uint32_t>(buf[i + 1]) << 16) | (static_cast<uint32_t>(buf[i + 2]) << 8) | buf[i + 3];
+			if (u == KEY_END) break;
+			out.push_back(u);
+		}
+		out.push_back(KEY_END);
+		return true;
+	}
+#endif
+
+	// Append the key of a string; keys compared unit by unit give the order of compare
+	// On Windows it is the sort key of the system; elsewhere a number becomes its count of significant digits
+	// and the digits, so that leading zeros are ignored
+	inline void append_key(std::vector<uint32_t>& out, std::wstring_view s) {
+#ifdef _WIN32
+		if (append_system_key(out, s)) return;
+#endif
+		for (size_t i = 0; i < s.size();) {
+			if (digit_value(s[i]) == -1) {
+				out.push_back(fold(s[i++]) + KEY_SHIFT);
+				continue;
+			}
+			while (i < s.size() && digit_value(s[i]) == 0) ++i;  // Skip leading zeros
+			size_t e = i;
+			while (e < s.size() && digit_value(s[e]) != -1) ++e;
+
+			out.push_back(KEY_NUMBER);
+			out.push_back(static_cast<uint32_t>(e - i) + KEY_SHIFT);
+			for (; i < e; ++i) out.push_back(static_cast<uint32_t>(digit_value(s[i])) + KEY_SHIFT);
+		}
+		out.push_back(KEY_END);
+	}
+
+	// Compare two keys made by append_key
+	inline int compare_key(const uint32_t* k1, const uint32_t* k2) noexcept {
+		for (; *k1 == *k2; ++k1, ++k2) {
+			if (*k1 == KEY_END) return 0;
+		}
+		return (*k1 < *k2) ? -1 : 1;
+	}
+
+	// Compare strings like StrCmpLogicalW: case is ignored, digits come before other characters,
+	// and runs of digits are compared by their values (by the collation of the system on Windows)
+	inline int compare(std::wstring_view s1, std::wstring_view s2) noexcept {
+#ifdef _WIN32
+		const int r = ::CompareStringEx(LOCALE_NAME_USER_DEFAULT, SYSTEM_FLAGS, s1.data(), static_cast<int>(s1.size()), s2.data(), static_cast<int>(s2.size()), nullptr, nullptr, 0);
+		if (r != 0) return r - CSTR_EQUAL;
+#endif
+		size_t i = 0, j = 0;
+		while (i < s1.size() && j < s2.size()) {
+			const bool d1 = digit_value(s1[i]) != -1;
+			const bool d2 = digit_value(s2[j]) != -1;
+			if (d1 != d2) return d1 ? -1 : 1;
+			if (!d1) {
+				const auto c1 = fold(s1[i++]);
+				const auto c2 = fold(s2[j++]);
+				if (c1 != c2) return (c1 < c2) ? -1 : 1;
+				continue;
+			}
+			while (i < s1.size() && digit_value(s1[i]) == 0) ++i;
+			while (j < s2.size() && digit_value(s2[j]) == 0) ++j;
+			size_t e1 = i, e2 = j;
+			while (e1 < s1.size() && digit_value(s1[e1]) != -1) ++e1;
+			while (e2 < s2.size() && digit_value(s2[e2]) != -1) ++e2;
+			if (e1 - i != e2 - j) return (e1 - i < e2 - j) ? -1 : 1;
+			for (; i < e1; ++i, ++j) {
+				const auto v1 = digit_value(s1[i]);
+				const auto v2 = digit_value(s2[j]);
+				if (v1 != v2) return (v1 < v2) ? -1 : 1;
+			}
+		}
+		if (i < s1.size()) return 1;
+		if (j < s2.size()) return -1;
+		return 0;
+	}
+
+};
@@ -2,34 +2,48 @@
  * Comparator of File Items
  *
  * @author Takuto Yanagida
- * @version 2026-04-29
+ * @version 2026-10-17
  */
 
 #pragma once
 
-#include <memory>
+#include <cstdint>
 
-#include <shlwapi.h>
-
-#include "item.h"
+#include "directory_snapshot.h"
 
 template <typename Derived> class CompBase {
 
 	bool rev_;
 
+protected:
+
+	const DirectorySnapshot* snap_;
+
 public:
 
-	CompBase(bool rev) noexcept : rev_(rev) {}
+	CompBase(const DirectorySnapshot& snap, bool rev) noexcept : rev_(rev), snap_(&snap) {}
 
-	bool operator()(const Item* it1, const Item* it2) const noexcept {
-		if (!it1 || !it2) {
-			return false;
-		}
+	bool less(uint32_t r1, uint32_t r2) const noexcept {
+		const bool d1 = (snap_->style(r1) & DirectorySnapshot::DIR) != 0;
+		const bool d2 = (snap_->style(r2) & DirectorySnapshot::DIR) != 0;
 		#pragma warning(suppress: 26491)
-		const bool ret = (it1->is_dir() != it2->is_dir())
-			? it1->is_dir() > it2->is_dir()
-			: static_cast<const Derived*>(this)->cmp(*it1, *it2);
-		return rev_ ? !ret : ret;
+		return (d1 != d2)
+			? d1 > d2
+			: static_cast<const Derived*>(this)->cmp(r1, r2);
+	}
+
+	// Reversed by swapping the operands so that equal items stay equal
+	bool operator()(uint32_t r1, uint32_t r2) const noexcept {
+		return rev_ ? less(r2, r1) : less(r1, r2);
+	}
+
+	// Integer key in the same order except for the ties broken in cmp (for comparators having value)
+	uint64_t radix_key(uint32_t r) const noexcept {
+		constexpr uint64_t VALUE_MASK = ~uint64_t{ 0 } >> 1;
+		const uint64_t dir = (snap_->style(r) & DirectorySnapshot::DIR) ? 1 : 0;
+		#pragma warning(suppress: 26491)
+		const uint64_t v   = static_cast<const Derived*>(this)->value(r) & VALUE_MASK;
+		return rev_ ? ((dir << 63) | (VALUE_MASK - v)) : (((1 - dir) << 63) | v);
 	}
 
 };
@@ -41,8 +55,8 @@ public:
 
 	using CompBase::CompBase;
 
-	bool cmp(const Item& it1, const Item& it2) const noexcept {
-		return ::StrCmpLogicalW(it1.name().c_str(), it2.name().c_str()) < 0;
+	bool cmp(uint32_t r1, uint32_t r2) const noexcept {
+		return snap_->compare_name(r1, r2) < 0;
 	}
 
 };
@@ -54,14 +68,13 @@ public:
 
 	using CompBase::CompBase;
 
-	bool cmp(const Item& it1, const Item& it2) const noexcept {
-		auto ext1 = path::ext(it1.path());
-		auto ext2 = path::ext(it2.path());
-		int res = ::lstrcmp(ext1.c_str(), ext2.c_str());
-		if (res == 0) {
-			res = ::StrCmpLogicalW(it1.name().c_str(), it2.name().c_str());
+	bool cmp(uint32_t r1, uint32_t r2) const noexcept {
+		const auto e1 = snap_->ext_rank(r1);
+		const auto e2 = snap_->ext_rank(r2);
+		if (e1 == e2) {
+			return snap_->compare_name(r1, r2) < 0;
 		}
-		return res < 0;
+		return e1 < e2;
 	}
 
 };
@@ -73,8 +86,13 @@ public:
 
 	using CompBase::CompBase;
 
-	bool cmp(const Item& it1, const Item& it2) const noexcept {
-		return ::CompareFileTime(&(it1.time()), &(it2.time())) == 1;
+	bool cmp(uint32_t r1, uint32_t r2) const noexcept {
+		return snap_->time(r1) > snap_->time(r2);
+	}
+
+	// Newer first
+	uint64_t value(uint32_t r) const noexcept {
+		return ~snap_->time(r);
 	}
 
 };
@@ -86,11 +104,15 @@ public:
 
 	using CompBase::CompBase;
 
-	bool cmp(const Item& it1, const Item& it2) const noexcept {
-		if (it1.size() == it2.size()) {
-			return ::StrCmpLogicalW(it1.name().c_str(), it2.name().c_str()) < 0;
+	bool cmp(uint32_t r1, uint32_t r2) const noexcept {
+		if (snap_->size(r1) == snap_->size(r2)) {
+			return snap_->compare_name(r1, r2) < 0;
 		}
-		return it1.size() < it2.size();
+		return snap_->size(r1) < snap_->size(r2);
+	}
+
+	uint64_t value(uint32_t r) const noexcept {
+		return snap_->size(r);
 	}
 
 };
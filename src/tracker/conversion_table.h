@@ -0,0 +1,112 @@
+/**
+ * Conversion Table (Romaji, Kana and Width Tables of Migemo)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <functional>
+#include <cwctype>
+
+#include "text_reader_writer.hpp"
+
+class ConversionTable {
+
+	std::map<std::wstring, std::wstring, std::less<>> map_;
+	size_t max_key_{};
+
+public:
+
+	ConversionTable() noexcept = default;
+	ConversionTable(const ConversionTable&) = delete;
+	ConversionTable& operator=(const ConversionTable&) = delete;
+	ConversionTable(ConversionTable&&) = delete;
+	ConversionTable& operator=(ConversionTable&&) = delete;
+	~ConversionTable() = default;
+
+	// Read lines of 'from' and 'to' separated by white spaces
+	// A line starting with '#' and a space is a comment, and '##' stands for '#'
+	bool load(const std::wstring& path) {
+		map_.clear();
+		max_key_ = 0;
+		const std::wstring text = text_reader_writer::read_cp932(path);
+		for (size_t pos = 0; pos < text.size();) {
+			size_t eol = text.find(L'\n', pos);
+			if (eol == std::wstring::npos) eol = text.size();
+			std::wstring_view line{ text.data() + pos, eol - pos };
+			pos = eol + 1;
+
+			if (line.empty()) continue;
+			if (line[0] == L'#') {
+				if (line.size() == 1 || std::iswspace(line[1])) continue;
+				if (line[1] == L'#') line.remove_prefix(1);
+			}
+			size_t i = 0;
+			while (i < line.size() && !std::iswspace(line[i])) ++i;
+			const auto from = line.substr(0, i);
+			while (i < line.size() && std::iswspace(line[i])) ++i;
+			size_t e = i;
+			while (e < line.size() && !std::iswspace(line[e])) ++e;
+			if (from.empty() || e == i) continue;
+
+			map_.insert_or_assign(std::wstring{ from }, std::wstring{ line.substr(i, e - i) });
+			if (from.size() > max_key_) max_key_ = from.size();
+		}
+		return !map_.empty();
+	}
+
+	bool empty() const noexcept {
+		return map_.empty();
+	}
+
+	const std::wstring* find(std::wstring_view key) const {
+		const auto it = map_.find(key);
+		return (it == map_.end()) ? nullptr : &it->second;
+	}
+
+	// Length of the longest key at the head of s (0 when none)
+	size_t longest_match(std::wstring_view s, const std::wstring*& to) const {
+		for (size_t len = (std::min)(s.size(), max_key_); len > 0; --len) {
+			if (const auto* t = find(s.substr(0, len))) {
+				to = t;
+				return len;
+			}
+		}
+		return 0;
+	}
+
+	// Call fn with the 'from' and 'to' of each entry whose 'from' starts with prefix
+	template<typename F> void each_with_prefix(std::wstring_view prefix, F fn) const {
+		for (auto it = map_.lower_bound(prefix); it != map_.end() && it->first.starts_with(prefix); ++it) {
+			fn(it->first, it->second);
+		}
+	}
+
+	// Whether a key longer than prefix starts with it, so that more input may change the conversion
+	bool has_longer(std::wstring_view prefix) const {
+		auto it = map_.lower_bound(prefix);
+		if (it != map_.end() && it->first == prefix) ++it;
+		return it != map_.end() && it->first.starts_with(prefix);
+	}
+
+	// Convert by the longest matches, keeping the characters not in the table
+	std::wstring convert(std::wstring_view s) const {
+		std::wstring ret;
+		for (size_t i = 0; i < s.size();) {
+			const std::wstring* to = nullptr;
+			if (const size_t len = longest_match(s.substr(i), to)) {
+				ret.append(*to);
+				i += len;
+			} else {
+				ret.push_back(s[i++]);
+			}
+		}
+		return ret;
+	}
+
+};
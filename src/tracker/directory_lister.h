@@ -0,0 +1,177 @@
+/**
+ * Directory Lister (Background Enumeration of a Folder)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <cstdint>
+
+#include "os.hpp"
+#include "file_system.hpp"
+
+class DirectoryLister {
+
+	inline static const size_t   FIRST_BATCH     = 64;   // Entries delivered as soon as they are found
+	inline static const uint64_t NOTIFY_INTERVAL = 100;  // Minimum interval of notifications [ms]
+
+public:
+
+	// Entries found but not taken yet (names are packed into one buffer)
+	class Batch {
+
+		struct Entry {
+			uint32_t off, len, attr;
+			uint64_t size, time;
+		};
+
+		std::wstring names_;
+		std::vector<Entry> es_;
+
+	public:
+
+		void add(const os::FindData& fd) {
+			es_.push_back({ static_cast<uint32_t>(names_.size()), static_cast<uint32_t>(fd.name.size()), fd.attr, fd.size, fd.time });
+			names_.append(fd.name);
+		}
+
+		void clear() noexcept {
+			names_.clear();
+			es_.clear();
+		}
+
+		size_t size() const noexcept {
+			return es_.size();
+		}
+
+		os::FindData at(size_t i) const {
+			const auto& e = es_.at(i);
+			return { std::wstring_view{ names_ }.substr(e.off, e.len), e.attr, e.size, e.time };
+		}
+
+	};
+
+private:
+
+	// Shared with the workers, which are left to end by themselves when canceled since they may be stuck in
+	// a folder not answering (results of the listings canceled are ignored by the generation)
+	struct State {
+		std::mutex mutex;
+		std::condition_variable cv;
+		Batch pending;
+		size_t found{};
+		bool done{ true };
+		bool posted{};
+		uint64_t gen{};
+		std::function<void()> notify;
+	};
+
+	std::shared_ptr<State> st_{ std::make_shared<State>() };
+
+	static void run(const std::shared_ptr<State>& st, uint64_t gen, const std::wstring& path) {
+		os::fail_critical_errors_in_thread();
+		auto last = os::tick_count();
+
+		file_system::find_first_file(path, [&](const std::wstring&, const os::FindData& fd) {
+			std::function<void()> notify;
+			bool first = false;
+			{
+				std::lock_guard lock(st->mutex);
+				if (st->gen != gen) return false;  // Canceled
+				st->pending.add(fd);
+				first = ++st->found == FIRST_BATCH;
+				const auto now = os::tick_count();
+				if (!st->posted && (first || now - last >= NOTIFY_INTERVAL)) {
+					st->posted = true;
+					notify = st->notify;
+					last = now;
+				}
+			}
+			if (first) st->cv.notify_all();
+			if (notify) notify();
+			return true;  // continue
+		});
+		std::function<void()> notify;
+		{
+			std::lock_guard lock(st->mutex);
+			if (st->gen != gen) return;
+			st->done = true;
+			if (!st->posted) {
+				st->posted = true;
+				notify = st->notify;
+			}
+		}
+		st->cv.notify_all();
+		if (notify) notify();
+	}
+
+public:
+
+	DirectoryLister() = default;
+	DirectoryLister(const DirectoryLister&) = delete;
+	DirectoryLister& operator=(const DirectoryLister&) = delete;
+	DirectoryLister(DirectoryLister&&) = delete;
+	DirectoryLister& operator=(DirectoryLister&&) = delete;
+
+	~DirectoryLister() {
+		std::lock_guard lock(st_->mutex);
+		++st_->gen;
+		st_->notify = nullptr;
+	}
+
+	// Set the function called from the worker when entries are ready to be taken
+	void set_notifier(std::function<void()> fn) {
+		std::lock_guard lock(st_->mutex);
+		st_->notify = std::move(fn);
+	}
+
+	// Start listing the folder (the previous listing is canceled)
+	void start(const std::wstring& path) {
+		uint64_t gen;
+		{
+			std::lock_guard lock(st_->mutex);
+			gen = ++st_->gen;
+			st_->pending.clear();
+			st_->found  = 0;
+			st_->done   = false;
+			st_->posted = false;
+		}
+		std::thread([st = st_, gen, path] { run(st, gen, path); }).detach();
+	}
+
+	// Stop the current listing and discard the entries not taken; the worker is not waited for
+	void cancel() {
+		std::lock_guard lock(st_->mutex);
+		++st_->gen;
+		st_->pending.clear();
+		st_->done = true;
+	}
+
+	// Wait until the first batch is found or the listing is done (returns true when done)
+	bool wait_first_batch(uint64_t timeout_ms) {
+		std::unique_lock lock(st_->mutex);
+		st_->cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] { return st_->done || st_->found >= FIRST_BATCH; });
+		return st_->done;
+	}
+
+	// Take the entries found so far (returns true when the listing is done)
+	bool take(Batch& out) {
+		out.clear();
+		std::lock_guard lock(st_->mutex);
+		std::swap(out, st_->pending);
+		st_->posted = false;
+		return st_->done;
+	}
+
+};
@@ -0,0 +1,408 @@
+/**
+ * Directory Snapshot (Structure of Arrays of File Entries)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <numeric>
+#include <algorithm>
+#include <cstdint>
+#include <cwctype>
+
+#include "os.hpp"
+#include "collator.hpp"
+#include "path.hpp"
+#include "type_table.h"
+#include "fuzzy_scorer.h"
+
+class DirectorySnapshot {
+
+	inline static const std::wstring EMPTY_STR{ L"empty" };
+
+	inline static const std::wstring EXT_FOLDER{ L"<folder>" };
+
+public:
+
+	enum : uint8_t { DIR = 2, HIDE = 4, LINK = 8, HIER = 16, EMPTY = 64, ABS = 128 };
+
+private:
+
+	// Texts of all rows; each text is followed by '\0'
+	// A row with ABS has its full path as text, otherwise its file name below parent_
+	std::wstring text_;
+	std::wstring parent_;
+
+	std::vector<uint32_t> text_off_;
+	std::vector<uint32_t> text_len_;
+	std::vector<uint32_t> name_off_;
+	std::vector<uint32_t> name_len_;
+	std::vector<uint64_t> time_;
+	std::vector<uint64_t> size_;
+	std::vector<uint8_t>  style_;
+	std::vector<int32_t>  color_;
+	std::vector<int32_t>  data_;
+	std::vector<uint32_t> id_;
+	std::vector<uint32_t> links_;  // Rows of the links whose targets are not resolved yet, in ascending order
+
+	// Sort keys built by prepare_keys
+	std::vector<uint32_t> key_;
+	std::vector<uint32_t> key_off_;
+	std::vector<uint32_t> ext_id_;
+	std::vector<std::wstring> exts_;  // Lower-cased extensions indexed by ext_id_
+	std::unordered_map<std::wstring, uint32_t> ext_ids_;
+	std::vector<uint32_t> ext_rank_;  // Order of exts_
+
+	std::vector<uint64_t> mask_;  // Masks of the characters of the names built by prepare_masks
+
+	std::wstring ext_buf_;
+
+	uint32_t append_text(std::wstring_view s) {
+		const auto off = static_cast<uint32_t>(text_.size());
+		text_.append(s).append(1, L'\0');
+		return off;
+	}
+
+	size_t push_row(std::wstring_view text, uint8_t style) {
+		const auto off = append_text(text);
+		text_off_.push_back(off);
+		text_len_.push_back(static_cast<uint32_t>(text.size()));
+		name_off_.push_back(off);
+		name_len_.push_back(static_cast<uint32_t>(text.size()));
+		time_.push_back(0);
+		size_.push_back(0);
+		style_.push_back(style);
+		color_.push_back(0);
+		data_.push_back(0);
+		id_.push_back(0);
+		return style_.size() - 1;
+	}
+
+	// Point the name of the row at its text, or copy it when it is not a terminated tail
+	void set_name(size_t row, std::wstring_view name) {
+		const auto* t_end = text_.data() + text_off_[row] + text_len_[row];
+		const auto* t_beg = text_.data() + text_off_[row];
+		if (!name.empty() && t_beg <= name.data() && name.data() + name.size() == t_end) {
+			name_off_[row] = static_cast<uint32_t>(name.data() - text_.data());
+		} else {
+			name_off_[row] = append_text(name);
+		}
+		name_len_[row] = static_cast<uint32_t>(name.size());
+	}
+
+	// Lower-cased extension of the name into ext_buf_, where the name may be a relative path of a file found below the parent
+	const std::wstring& ext_of(std::wstring_view name) {
+		const auto pos = name.find_last_of(path::EXT_PREFIX);
+		const auto sep = name.find_last_of(path::PATH_SEPARATOR);
+		const bool none = pos == std::wstring_view::npos || (sep != std::wstring_view::npos && pos < sep);
+		return lower_into_ext_buf(none ? std::wstring_view{} : name.substr(pos + 1));
+	}
+
+	const std::wstring& lower_into_ext_buf(std::wstring_view ext) {
+		ext_buf_.clear();
+		for (const auto c : ext) ext_buf_.push_back(static_cast<wchar_t>(std::towlower(c)));
+		return ext_buf_;
+	}
+
+	// Rank the extensions in the order of os::compare_string (equal ones share a rank)
+	void rank_exts() {
+		std::vector<uint32_t> idx(exts_.size());
+		std::iota(idx.begin(), idx.end(), uint32_t{ 0 });
+		std::sort(idx.begin(), idx.end(), [&](uint32_t a, uint32_t b) {
+			return os::compare_string(exts_[a].c_str(), exts_[b].c_str()) < 0;
+		});
+		ext_rank_.resize(exts_.size());
+		uint32_t rank = 0;
+		for (size_t i = 0; i < idx.size(); ++i) {
+			if (i > 0 && os::compare_string(exts_[idx[i - 1]].c_str(), exts_[idx[i]].c_str()) != 0) ++rank;
+			ext_rank_[idx[i]] = rank;
+		}
+	}
+
+	void check_file(size_t row, bool is_dir, bool is_hidden, const TypeTable& exts, bool is_missing = false) {
+		const std::wstring_view nv{ text_.data() + name_off_[row], name_len_[row] };
+		uint8_t style = style_[row] & ABS;
+
+		if (!is_dir && ext_of(nv) == L"lnk") {  // When it is a link
+			const std::wstring name{ nv.substr(0, nv.size() - 4) };  // remove .lnk
+			set_name(row, name);
+
+			if (is_missing) {  // When the link is broken
+				style_[row] = style | LINK | HIDE;
+				color_[row] = -1;
+				return;
+			}
+			links_.push_back(static_cast<uint32_t>(row));  // Colored by the link itself until its target is resolved
+			style |= LINK;
+		}
+		style_[row] = style | (is_dir ? DIR : 0) | (is_hidden ? HIDE : 0);
+		color_[row] = exts.get_color(is_dir ? EXT_FOLDER : ext_buf_);
+	}
+
+public:
+
+	DirectorySnapshot() noexcept = default;
+	DirectorySnapshot(const DirectorySnapshot&) = delete;
+	DirectorySnapshot& operator=(const DirectorySnapshot&) = delete;
+	DirectorySnapshot(DirectorySnapshot&&) = default;
+	DirectorySnapshot& operator=(DirectorySnapshot&&) = default;
+	~DirectorySnapshot() = default;
+
+	// Remove all rows (capacities are kept)
+	void clear() noexcept {
+		text_.clear();
+		parent_.clear();
+		text_off_.clear();
+		text_len_.clear();
+		name_off_.clear();
+		name_len_.clear();
+		time_.clear();
+		size_.clear();
+		style_.clear();
+		color_.clear();
+		data_.clear();
+		id_.clear();
+		links_.clear();
+		key_.clear();
+		key_off_.clear();
+		ext_id_.clear();
+		exts_.clear();
+		ext_ids_.clear();
+		ext_rank_.clear();
+		mask_.clear();
+	}
+
+	void reserve(size_t rows, size_t chars) {
+		text_.reserve(chars);
+		text_off_.reserve(rows);
+		text_len_.reserve(rows);
+		name_off_.reserve(rows);
+		name_len_.reserve(rows);
+		time_.reserve(rows);
+		size_.reserve(rows);
+		style_.reserve(rows);
+		color_.reserve(rows);
+		data_.reserve(rows);
+		id_.reserve(rows);
+	}
+
+	// Release capacity beyond the given numbers of rows and characters (rows are removed)
+	void trim(size_t rows, size_t chars) {
+		clear();
+		if (text_.capacity() > chars) {
+			text_.shrink_to_fit();
+			text_.reserve(chars);
+		}
+		if (style_.capacity() > rows) {
+			DirectorySnapshot tmp;
+			tmp.reserve(rows, 0);
+			tmp.text_.swap(text_);
+			*this = std::move(tmp);
+		}
+	}
+
+	// Number of bytes allocated for the rows
+	size_t footprint() const noexcept {
+		return text_.capacity() * sizeof(wchar_t) + parent_.capacity() * sizeof(wchar_t) +
+			(text_off_.capacity() + text_len_.capacity() + name_off_.capacity() + name_len_.capacity()) * sizeof(uint32_t) +
+			(time_.capacity() + size_.capacity()) * sizeof(uint64_t) +
+			style_.capacity() * sizeof(uint8_t) +
+			(color_.capacity() + data_.capacity()) * sizeof(int32_t) +
+			(id_.capacity() + links_.capacity()) * sizeof(uint32_t) +
+			(key_.capacity() + key_off_.capacity() + ext_id_.capacity() + ext_rank_.capacity()) * sizeof(uint32_t) +
+			mask_.capacity() * sizeof(uint64_t);
+	}
+
+	// Build the sort keys of the rows added since the last call
+	void prepare_keys() {
+		const auto ext_count = exts_.size();
+		for (size_t r = key_off_.size(); r < size(); ++r) {
+			key_off_.push_back(static_cast<uint32_t>(key_.size()));
+			collator::append_key(key_, name(r));
+
+			const auto [it, inserted] = ext_ids_.try_emplace(lower_into_ext_buf(ext(r)), static_cast<uint32_t>(exts_.size()));
+			if (inserted) exts_.push_back(ext_buf_);
+			ext_id_.push_back(it->second);
+		}
+		if (exts_.size() != ext_count || ext_rank_.size() != exts_.size()) rank_exts();
+	}
+
+	// Build the masks of the characters of the names of the rows added since the last call
+	void prepare_masks() {
+		for (size_t r = mask_.size(); r < size(); ++r) mask_.push_back(FuzzyScorer::mask_of(name(r)));
+	}
+
+	// Mask of the characters of the name of the row (all bits when prepare_masks is not called for it)
+	uint64_t char_mask(size_t row) const noexcept {
+		return (row < mask_.size()) ? mask_[row] : ~uint64_t{};
+	}
+
+	// Compare the names of rows by their sort keys (prepare_keys must be called)
+	int compare_name(size_t r1, size_t r2) const noexcept {
+		return collator::compare_key(key_.data() + key_off_[r1], key_.data() + key_off_[r2]);
+	}
+
+	// Order of the extension of the row (prepare_keys must be called)
+	uint32_t ext_rank(size_t row) const noexcept {
+		return ext_rank_[ext_id_[row]];
+	}
+
+	size_t text_size() const noexcept {
+		return text_.size();
+	}
+
+	size_t text_capacity() const noexcept {
+		return text_.capacity();
+	}
+
+	// Set the folder of the rows added by add_file (must include \ at the end)
+	void set_parent(const std::wstring& parent_path) {
+		parent_.assign(parent_path);
+	}
+
+	const std::wstring& parent() const noexcept {
+		return parent_;
+	}
+
+	// Add a file found in the parent folder
+	size_t add_file(const os::FindData& fd, const TypeTable& exts) {
+		const auto row = push_row(fd.name, 0);
+		time_[row] = fd.time;
+		size_[row] = fd.size;
+
+		const auto is_dir    = (fd.attr & os::ATTR_DIRECTORY) != 0;
+		const auto is_hidden = (fd.attr & os::ATTR_HIDDEN)    != 0;
+
+		check_file(row, is_dir, is_hidden, exts);
+		return row;
+	}
+
+	// Add a file specified by its full path
+	size_t add_path(const std::wstring& path, const TypeTable& exts, size_t id = 0) {
+		return add_path(path, exts, id, os::file_attributes(path));
+	}
+
+	// Add a file specified by its full path with its attributes known
+	size_t add_path(const std::wstring& path, const TypeTable& exts, size_t id, uint32_t attr) {
+		const auto row = push_row(path, ABS);
+		id_[row] = static_cast<uint32_t>(id);
+		if (!path.empty() && path.back() != path::PATH_SEPARATOR) {  // Refer to the tail of the stored text
+			const std::wstring_view t{ text_.data() + text_off_[row], text_len_[row] };
+			const auto pos = t.find_last_of(path::PATH_SEPARATOR);
+			set_name(row, (pos == std::wstring_view::npos) ? t : t.substr(pos + 1));
+		} else if (!path.empty()) {
+			set_name(row, path::name(path));
+		}
+
+		auto is_dir     = (attr & os::ATTR_DIRECTORY) != 0;
+		auto is_hidden  = (attr & os::ATTR_HIDDEN) != 0;
+
+		// When there is no file
+		if (attr == os::ATTR_INVALID) {
+			is_dir    = false;
+			is_hidden = true;
+		}
+		// Measures to prevent drive from appearing as hidden file
+		if (path::is_root(path)) is_hidden = false;
+
+		check_file(row, is_dir, is_hidden, exts, attr == os::ATTR_INVALID);  // File item check
+		return row;
+	}
+
+	size_t add_empty() {
+		const auto row = push_row(L"", ABS | EMPTY);
+		set_name(row, EMPTY_STR);
+		return row;
+	}
+
+	size_t add_special(const std::wstring& path, const std::wstring& name) {
+		const auto row = push_row(path, ABS | DIR);
+		set_name(row, name);
+		color_[row] = os::gray_text_color();
+		return row;
+	}
+
+	size_t add_separator(int data) {
+		const auto row = push_row(L"", ABS);
+		data_[row] = data;
+		return row;
+	}
+
+	// ----
+
+	size_t size() const noexcept {
+		return style_.size();
+	}
+
+	std::wstring path(size_t row) const {
+		const std::wstring_view t{ text_.data() + text_off_[row], text_len_[row] };
+		if (style_[row] & ABS) return std::wstring{ t };
+		std::wstring ret;
+		ret.reserve(parent_.size() + t.size());
+		return ret.append(parent_).append(t);
+	}
+
+	// The name is always followed by '\0'
+	std::wstring_view name(size_t row) const noexcept {
+		return { text_.data() + name_off_[row], name_len_[row] };
+	}
+
+	// Extension of the actual file name as it is (empty when there is none)
+	std::wstring_view ext(size_t row) const noexcept {
+		const std::wstring_view t{ text_.data() + text_off_[row], text_len_[row] };
+		const auto pos = t.find_last_of(path::EXT_PREFIX);
+		if (pos == std::wstring_view::npos) return {};
+		const auto sep = t.find_last_of(path::PATH_SEPARATOR);
+		if (sep != std::wstring_view::npos && pos < sep) return {};
+		return t.substr(pos + 1);
+	}
+
+	uint64_t time(size_t row) const noexcept {
+		return time_[row];
+	}
+
+	uint64_t size(size_t row) const noexcept {
+		return size_[row];
+	}
+
+	// Set the size calculated later (total size of a folder)
+	void set_size(size_t row, uint64_t size) noexcept {
+		size_[row] = size;
+	}
+
+	uint8_t style(size_t row) const noexcept {
+		return style_[row];
+	}
+
+	int color(size_t row) const noexcept {
+		return color_[row];
+	}
+
+	// Whether the row is a link whose target is not resolved yet
+	bool is_unresolved_link(size_t row) const noexcept {
+		return std::binary_search(links_.begin(), links_.end(), static_cast<uint32_t>(row));
+	}
+
+	// Color the link by the extension of its target resolved later (empty when it is not resolved)
+	void set_link_target(size_t row, std::wstring_view target, const TypeTable& exts) {
+		const auto it = std::lower_bound(links_.begin(), links_.end(), static_cast<uint32_t>(row));
+		if (it == links_.end() || *it != row) return;
+		links_.erase(it);
+		color_[row] = exts.get_color(ext_of(path::name(std::wstring{ target })));
+	}
+
+	int data(size_t row) const noexcept {
+		return data_[row];
+	}
+
+	size_t id(size_t row) const noexcept {
+		return id_[row];
+	}
+
+};
@@ -0,0 +1,186 @@
+/**
+ * Directory Watcher (Change Notification of Folders)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#include "os.hpp"
+
+#ifdef _WIN32
+#include <dbt.h>
+#else
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <climits>
+#endif
+
+class DirectoryWatcher {
+
+#ifdef _WIN32
+	struct Watch {
+		std::wstring path;
+		HANDLE dir{ INVALID_HANDLE_VALUE };
+		HDEVNOTIFY dev{};
+		OVERLAPPED ov{};
+		DWORD buf[256]{};
+	};
+
+	std::vector<std::unique_ptr<Watch>> ws_;
+	std::vector<std::wstring> released_;  // Folders whose devices are being removed
+	HWND wnd_{};
+
+	static bool request(Watch& w) noexcept {
+		const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_ATTRIBUTES |
+			FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+		return ::ReadDirectoryChangesW(w.dir, &w.buf, sizeof(w.buf), FALSE, filter, nullptr, &w.ov, nullptr) != 0;
+	}
+
+	static void close(Watch& w) noexcept {
+		if (w.dir == INVALID_HANDLE_VALUE) return;
+		if (w.dev) ::UnregisterDeviceNotification(w.dev);
+		DWORD size{};
+		::CancelIoEx(w.dir, &w.ov);
+		::GetOverlappedResult(w.dir, &w.ov, &size, TRUE);
+		::CloseHandle(w.dir);
+		w.dir = INVALID_HANDLE_VALUE;
+	}
+#else
+	struct Watch {
+		std::wstring path;
+		int wd{ -1 };
+	};
+
+	std::vector<std::unique_ptr<Watch>> ws_;
+	int fd_{ -1 };
+#endif
+
+public:
+
+	DirectoryWatcher() noexcept {
+#ifndef _WIN32
+		fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+	}
+
+	DirectoryWatcher(const DirectoryWatcher&) = delete;
+	DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+	DirectoryWatcher(DirectoryWatcher&&) = delete;
+	DirectoryWatcher& operator=(DirectoryWatcher&&) = delete;
+
+	~DirectoryWatcher() {
+		clear();
+#ifndef _WIN32
+		if (fd_ != -1) ::close(fd_);
+#endif
+	}
+
+	// Start watching the folder afresh (returns false when it cannot be watched)
+	bool add(const std::wstring& path) {
+		remove(path);
+		auto w = std::make_unique<Watch>();
+		w->path = path;
+#ifdef _WIN32
+		w->dir = ::CreateFile(path.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+		if (w->dir == INVALID_HANDLE_VALUE) return false;
+		if (!request(*w)) {
+			close(*w);
+			return false;
+		}
+		if (wnd_) {  // So that the handle is closed before the device is removed
+			DEV_BROADCAST_HANDLE dbh{};
+			dbh.dbch_size       = sizeof(dbh);
+			dbh.dbch_devicetype = DBT_DEVTYP_HANDLE;
+			dbh.dbch_handle     = w->dir;
+			w->dev = ::RegisterDeviceNotification(wnd_, &dbh, DEVICE_NOTIFY_WINDOW_HANDLE);
+		}
+#else
+		if (fd_ == -1) return false;
+		w->wd = ::inotify_add_watch(fd_, os::to_utf8(path).c_str(),
+			IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB | IN_MODIFY | IN_DELETE_SELF | IN_MOVE_SELF);
+		if (w->wd == -1) return false;
+#endif
+		ws_.push_back(std::move(w));
+		return true;
+	}
+
+	// Stop watching the folder
+	void remove(const std::wstring& path) {
+		const auto it = std::find_if(ws_.begin(), ws_.end(), [&](const auto& w) { return w->path == path; });
+		if (it == ws_.end()) return;
+#ifdef _WIN32
+		close(**it);
+#else
+		::inotify_rm_watch(fd_, (*it)->wd);
+#endif
+		ws_.erase(it);
+	}
+
+	void clear() {
+		while (!ws_.empty()) remove(ws_.back()->path);
+#ifdef _WIN32
+		released_.clear();
+#endif
+	}
+
+#ifdef _WIN32
+	// Set the window to which WM_DEVICECHANGE is sent when the device of a folder is about to be removed
+	void set_window(HWND wnd) noexcept {
+		wnd_ = wnd;
+	}
+
+	// Stop watching the folder of the handle whose device is about to be removed; it is reported as changed
+	void release(HANDLE dir) {
+		const auto it = std::find_if(ws_.begin(), ws_.end(), [&](const auto& w) { return w->dir == dir; });
+		if (it == ws_.end()) return;
+		released_.push_back((*it)->path);
+		remove(released_.back());
+	}
+#endif
+
+	bool is_watching(const std::wstring& path) const {
+		return std::any_of(ws_.begin(), ws_.end(), [&](const auto& w) { return w->path == path; });
+	}
+
+	// Return the folders changed since they were added; they are no longer watched
+	std::vector<std::wstring> changed() {
+		std::vector<std::wstring> ret;
+#ifdef _WIN32
+		ret.swap(released_);
+		for (const auto& w : ws_) {
+			if (HasOverlappedIoCompleted(&w->ov)) ret.push_back(w->path);
+		}
+#else
+		if (fd_ == -1) return ret;
+		bool overflowed = false;
+		alignas(inotify_event) char buf[sizeof(inotify_event) * 16 + NAME_MAX + 1];
+		for (;;) {
+			const auto len = ::read(fd_, buf, sizeof(buf));
+			if (len <= 0) break;
+			for (ssize_t off = 0; off < len;) {
+				const auto* e = reinterpret_cast<const inotify_event*>(buf + off);
+				if (e->mask & IN_Q_OVERFLOW) overflowed = true;  // Events were dropped, so any folder may have been changed
+				for (const auto& w : ws_) {
+					if (w->wd == e->wd && std::find(ret.begin(), ret.end(), w->path) == ret.end()) ret.push_back(w->path);
+				}
+				off += sizeof(inotify_event) + e->len;
+			}
+		}
+		if (overflowed) {
+			ret.clear();
+			for (const auto& w : ws_) ret.push_back(w->path);
+		}
+#endif
+		for (const auto& p : ret) remove(p);
+		return ret;
+	}
+
+};
@@ -2,12 +2,13 @@
  * Document
  *
  * @author Takuto Yanagida
- * @version 2026-05-13
+ * @version 2026-10-17
  */
 
 #pragma once
 
 #include <string>
+#include <functional>
 
 #include <windows.h>
 
@@ -15,6 +16,13 @@
 #include "pref.hpp"
 #include "selection.h"
 #include "item_list.h"
+#include "listing_arena.h"
+#include "directory_lister.h"
+#include "subtree_searcher.h"
+#include "path_index.h"
+#include "folder_sizer.h"
+#include "link_resolver.h"
+#include "listing_cache.h"
 #include "item.h"
 #include "type_table.h"
 #include "observer.h"
@@ -26,6 +34,12 @@
 
 class Document {
 
+	inline static const uint64_t FIRST_WAIT = 50;  // Time to wait for the first batch before showing the list [ms]
+
+	inline static const std::wstring INDEX_FILE_NAME{ L"path_index.dat" };
+	inline static const uint64_t INDEX_REBUILD_INTERVAL = 10 * 60 * 1000;  // Age of the index to be rebuilt when searched, unless tracked [ms]
+	inline static const size_t   MAX_INDEX_HITS         = 1000;
+
 public:
 
 	enum class ListType { FILE, HIER = 64 };
@@ -42,6 +56,22 @@ private:
 
 	std::wstring cur_path_, last_cur_path_;
 	ItemList files_, navis_;
+	ListingArena arena_;
+	DirectoryLister lister_;
+	DirectoryLister::Batch batch_;
+	bool listing_{};
+	SubtreeSearcher searcher_;
+	bool subtree_{};  // Whether files_ has the files found below cur_path_ instead of its children
+	bool indexed_{};  // Whether the files below cur_path_ are searched in the index
+	PathIndex index_;  // Names below the folders of the bookmarks and the history
+	FolderSizer sizer_;
+	FolderSizer::Sizes sizes_;
+	LinkResolver resolver_;
+	LinkResolver::Targets targets_;
+	ExistenceChecker checker_;  // Existence of the paths of the history and the current folder
+	ListingCache cache_;
+	std::wstring folder_path_;  // Normal folder listed in files_
+	int folder_flags_{};
 	Option opt_;
 
 	int special_sep_opt_data_;
@@ -50,9 +80,7 @@ private:
 	void append_drives_to_files() {
 		dri_.clean_up();
 		for (size_t i = 0; i < dri_.size(); ++i) {
-			const auto it = Item::create();
-			it->set_file(dri_[i], exts_);
-			files_.add(it);
+			files_.add(files_.snapshot().add_path(dri_[i], exts_));
 		}
 	}
 
@@ -63,72 +91,164 @@ private:
 		std::wstring cur(path);
 
 		while (!cur.empty()) {
-			const auto it = Item::create();
-			it->set_file(cur, exts_);
-			navis_.insert(last, it);
+			navis_.insert(last, navis_.snapshot().add_path(cur, exts_));
 			cur = path::parent(cur);
 		}
-		const auto it = Item::create();
-		it->data() = hierarchy_sep_opt_data_;
-		navis_.add(it);
-
-		// Add files
-		file_system::find_first_file(path, [&](const std::wstring& parent, const WIN32_FIND_DATA& wfd) {
-			const bool is_hidden = (wfd.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN) != 0;
-			const bool is_dot    = wfd.cFileName[0] == L'.';
-			if (
-				(!is_hidden && !is_dot) ||
-				(is_dot && !opt_.is_dot_file_as_hidden()) ||
-				opt_.is_show_hidden()
-			) {
-				const auto it = Item::create();
-				it->set_file(parent, wfd, exts_);
-				files_.add(it);
+		navis_.add(navis_.snapshot().add_separator(hierarchy_sep_opt_data_));
+
+		// Use the listing kept when the folder was left if it has not been changed since then
+		folder_path_  = path;
+		folder_flags_ = (opt_.is_show_hidden() ? 1 : 0) | (opt_.is_dot_file_as_hidden() ? 2 : 0);
+		if (auto snap = cache_.take(path, folder_flags_)) {
+			files_.assign(std::move(*snap));
+			opt_.sort_files(files_);
+			return;
+		}
+		cache_.watch(path);
+
+		// Add files (the rest are received from the lister when not done in a moment)
+		std::wstring parent{ path };
+		if (parent.back() != path::PATH_SEPARATOR) parent.append(1, path::PATH_SEPARATOR);
+		files_.snapshot().set_parent(parent);
+		lister_.start(path);
+		lister_.wait_first_batch(FIRST_WAIT);
+		listing_ = !add_listed_files();
+		if (!listing_) opt_.sort_files(files_);
+	}
+
+	bool is_shown(const os::FindData& fd) const {
+		const bool is_hidden = (fd.attr & os::ATTR_HIDDEN) != 0;
+		const bool is_dot    = fd.name[fd.name.find_last_of(path::PATH_SEPARATOR) + 1] == L'.';  // Names of subtree search are paths
+		return (!is_hidden && !is_dot) || (is_dot && !opt_.is_dot_file_as_hidden()) || opt_.is_show_hidden();
+	}
+
+	// Add the files found by the lister so far (returns true when the listing is done)
+	bool add_listed_files() {
+		const bool done = indexed_ ? index_.take(batch_) : subtree_ ? searcher_.take(batch_) : lister_.take(batch_);
+		auto& snap = files_.snapshot();
+		for (size_t i = 0; i < batch_.size(); ++i) {
+			const auto fd = batch_.at(i);
+			if (is_shown(fd)) files_.add(snap.add_file(fd, exts_));
+		}
+		return done;
+	}
+
+	// Build the index of the folders in the bookmarks and the history in the background
+	void start_indexing() {
+		std::vector<std::wstring> roots;
+		for (size_t i = 0; i < fav_.size(); ++i) roots.push_back(fav_[i]);
+		for (size_t i = 0; i < his_.size(); ++i) roots.push_back(his_[i]);
+		index_.start(path::parent(pref_.path()).append(1, path::PATH_SEPARATOR).append(INDEX_FILE_NAME), std::move(roots));
+	}
+
+	// Show the files in the index whose names match, with their paths as their names; they are searched in
+	// the background and received like listed files
+	bool search_index(const std::function<void(Matcher&)>& setup) {
+		if (!index_.is_building() && !index_.is_tracking() && index_.age() > INDEX_REBUILD_INTERVAL) start_indexing();
+		if (index_.size() == 0) return false;
+		leave_folder(true);
+		files_.snapshot().set_parent(L"");
+		index_.search(setup, MAX_INDEX_HITS);
+		subtree_ = indexed_ = listing_ = true;
+		observer_->updated();
+		return true;
+	}
+
+	// Receive the targets of the links resolved in the background
+	void receive_link_targets() {
+		resolver_.take(targets_);
+		if (targets_.empty()) return;
+		auto& snap = files_.snapshot();
+		for (const auto& [row, target] : targets_) snap.set_link_target(row, target, exts_);
+		observer_->appended();
+	}
+
+	// Show the history again when the volumes of its paths have answered
+	void receive_existence() {
+		if (!checker_.take_changed() || !in_history()) return;
+		make_file_list();
+		observer_->updated();
+	}
+
+	// Complete the file list
+	void finish_file_list() {
+		if (files_.size() == 0 && !files_.is_filtered()) {
+			files_.add(files_.snapshot().add_empty());
+		}
+		arena_.record(files_);
+		size_folders();
+	}
+
+	// Calculate the total sizes of the folders listed in the background when sorted by sizes
+	void size_folders() {
+		sizer_.cancel();
+		if (subtree_ || listing_ || folder_path_.empty() || opt_.get_sort_type() != 3) return;
+		std::vector<std::pair<uint32_t, std::wstring>> dirs;
+		for (size_t i = 0; i < files_.size(); ++i) {
+			const Item it = files_.at(i);
+			if (it.is_dir() && !it.is_link()) dirs.emplace_back(static_cast<uint32_t>(it.row()), it.path());
+		}
+		sizer_.start(std::move(dirs));
+	}
+
+	// Receive the sizes of the folders calculated in the background
+	void receive_folder_sizes() {
+		sizer_.take(sizes_);
+		if (sizes_.empty()) return;
+		files_.set_sizes(sizes_);
+		observer_->appended();
+	}
+
+	// Keep the listing of the folder being left (also when it is listed again if keep_current is true)
+	void leave_folder(bool keep_current) {
+		lister_.cancel();
+		searcher_.cancel();
+		index_.cancel_search();
+		sizer_.cancel();
+		resolver_.cancel();
+		subtree_ = indexed_ = false;
+		if (!folder_path_.empty()) {
+			if (listing_) cache_.remove(folder_path_);
+			else if (keep_current || folder_path_ != cur_path_) {
+				cache_.put(folder_path_, folder_flags_, files_.release());
+				files_.assign(cache_.take_spare());  // The memory of a listing dropped from the cache is recycled
 			}
-			return true;  // continue
-		});
-		opt_.sort_files(files_);
+			folder_path_.clear();
+		}
+		listing_ = false;
+		arena_.recycle(files_);
 	}
 
 	// Make a file list
 	void make_file_list() {
-		files_.clear();
+		leave_folder(false);
 		navis_.clear();
 
-		const auto it_fav = Item::create();
-		const auto it_his = Item::create();
-		const auto it_dri = Item::create();
-		it_fav->set_special(fav_.PATH, fav_.NAME);
-		it_his->set_special(his_.PATH, his_.NAME);
-		it_dri->set_special(dri_.PATH, dri_.NAME);
-		navis_.add(it_fav);
-		navis_.add(it_his);
-		navis_.add(it_dri);
-
-		const auto it_sp = Item::create();
-		it_sp->data() = special_sep_opt_data_;
-		navis_.add(it_sp);
+		auto& ns = navis_.snapshot();
+		navis_.add(ns.add_special(fav_.PATH, fav_.NAME));
+		navis_.add(ns.add_special(his_.PATH, his_.NAME));
+		navis_.add(ns.add_special(dri_.PATH, dri_.NAME));
+		navis_.add(ns.add_separator(special_sep_opt_data_));
 
 		const ErrorMode em;
 		if (cur_path_ == fav_.PATH) {
 			for (size_t i = 0; i < fav_.size(); ++i) {
-				const auto it = Item::create();
-				it->set_file(fav_[i], exts_, i);
-				files_.add(it);
+				files_.add(files_.snapshot().add_path(fav_[i], exts_, i));
 			}
 		} else if (cur_path_ == his_.PATH) {
-			his_.clean_up();
+			his_.clean_up(checker_);
 			for (size_t i = 0; i < his_.size(); ++i) {
-				const auto it = Item::create();
-				it->set_file(his_[i], exts_, i);
-				files_.add(it);
+				uint32_t attr;
+				if (!checker_.cached(his_[i], attr)) attr = os::ATTR_HIDDEN;  // Grayed until it is probed
+				files_.add(files_.snapshot().add_path(his_[i], exts_, i, attr));
 			}
 			opt_.sort_history(files_);
 		} else if (cur_path_ == dri_.PATH) {
 			append_drives_to_files();
 		} else {
-			while (!cur_path_.empty()) {  // Go back to the folder where the file exists
-				if (file_system::is_existing(cur_path_)) break;
+			while (!cur_path_.empty()) {  // Go back to the folder where the file exists (also when it is not known)
+				uint32_t attr;
+				if (!checker_.attributes(cur_path_, attr) || attr != os::ATTR_INVALID) break;
 				cur_path_ = path::parent(cur_path_);
 			}
 			if (!cur_path_.empty()) set_normal_folder(cur_path_);  // Folder found
@@ -136,11 +256,7 @@ private:
 				append_drives_to_files();
 			}
 		}
-		if (files_.size() == 0) {
-			const auto it = Item::create();
-			it->set_empty();
-			files_.add(it);
-		}
+		if (!listing_) finish_file_list();
 	}
 
 public:
@@ -160,9 +276,17 @@ public:
 			fav_.restore(pref_);
 			his_.restore(pref_);
 		}
+		start_indexing();
 	}
 
 	void finalize() {
+		lister_.cancel();
+		searcher_.cancel();
+		sizer_.cancel();
+		resolver_.cancel();
+		index_.cancel_search();
+		index_.cancel();
+		cache_.clear();
 		fav_.store();
 		his_.store();
 		opt_.store(pref_);
@@ -175,6 +299,120 @@ public:
 		observer_->updated();
 	}
 
+	// Set the window to which WM_DEVICECHANGE is sent when the device of a folder kept in the cache is about to
+	// be removed
+	void set_device_window(HWND wnd) noexcept {
+		cache_.set_window(wnd);
+	}
+
+	// Release the handle of the folder on the device about to be removed
+	void release_device(HANDLE dir) {
+		cache_.release(dir);
+	}
+
+	// Set the function called from the worker thread when listed files, sizes of folders, targets of links or
+	// existence of paths are ready
+	void set_listing_notifier(std::function<void()> fn) {
+		lister_.set_notifier(fn);
+		sizer_.set_notifier(fn);
+		resolver_.set_notifier(fn);
+		checker_.set_notifier(fn);
+		index_.set_notifier(fn);
+		searcher_.set_notifier(std::move(fn));
+	}
+
+	// Show the files below the current folder whose names match, searched by the matchers made by setup
+	// in the background; they are received like listed files, and Update returns to the folder
+	// In the bookmarks and the history, the files below their folders are searched in the index instead
+	bool search_subtree(const std::function<void(Matcher&)>& setup) {
+		if (cur_path_ == fav_.PATH || cur_path_ == his_.PATH) return search_index(setup);
+		if (in_drives() || cur_path_.empty()) return false;
+		leave_folder(true);
+		std::wstring parent{ cur_path_ };
+		if (parent.back() != path::PATH_SEPARATOR) parent.append(1, path::PATH_SEPARATOR);
+		files_.snapshot().set_parent(parent);
+		searcher_.start(cur_path_, setup);
+		subtree_ = listing_ = true;
+		observer_->updated();
+		return true;
+	}
+
+	// Whether the file list shows the files found below the current folder
+	bool in_subtree_search() const noexcept {
+		return subtree_;
+	}
+
+	// Receive the files listed in the background; the list is sorted when the listing is done
+	// The sizes of the folders, the targets of the links and the existence of the paths of the history probed
+	// in the background are also received
+	void receive_listed_files() {
+		receive_folder_sizes();
+		receive_link_targets();
+		receive_existence();
+		if (!listing_) return;
+		if (add_listed_files()) {
+			listing_ = false;
+			opt_.sort_files(files_);
+			finish_file_list();
+			observer_->updated();
+		} else {
+			observer_->appended();
+		}
+	}
+
+	// Resolve the targets of the links among the files in the range shown, in the background unless cached
+	void resolve_links(size_t first, size_t last) {
+		auto& snap = files_.snapshot();
+		std::vector<LinkResolver::Request> reqs;
+		std::wstring target;
+		for (size_t i = first; i < (std::min)(last, files_.size()); ++i) {
+			const auto row = files_.at(i).row();
+			if (!snap.is_unresolved_link(row)) continue;
+			auto path = snap.path(row);
+			if (resolver_.cached(path, snap.time(row), target)) {
+				snap.set_link_target(row, target, exts_);
+			} else {
+				reqs.push_back({ static_cast<uint32_t>(row), std::move(path), snap.time(row) });
+			}
+		}
+		if (!reqs.empty()) resolver_.request(std::move(reqs));
+	}
+
+	// Whether the file list is still being listed
+	bool is_listing() const noexcept {
+		return listing_;
+	}
+
+	// Apply the sort options to the files without listing the folder again
+	void resort() {
+		if (subtree_) {
+			if (!listing_) opt_.sort_files(files_);  // Sorted when the search is done
+			observer_->updated();
+			return;
+		}
+		if (folder_path_.empty() || listing_) {
+			Update();
+			return;
+		}
+		opt_.sort_files(files_);
+		size_folders();
+		observer_->updated();
+	}
+
+	// Show only the files matching the filter; the files shown now are narrowed when narrow is true
+	void filter_files(std::function<bool(const Item&)> f, bool narrow) {
+		files_.filter(std::move(f), narrow);
+	}
+
+	// Show only the files scored above zero in the order of the scores
+	void rank_files(std::function<int(const Item&)> score, bool narrow) {
+		files_.rank(std::move(score), narrow);
+	}
+
+	void unfilter_files() {
+		files_.unfilter();
+	}
+
 	void set_current_directory(const std::wstring& path) {
 		if (path != cur_path_) {
 			last_cur_path_.assign(cur_path_);
@@ -185,24 +423,24 @@ public:
 
 	// Move to lower folder
 	bool move_to_lower(ListType w, size_t index) {
-		const std::shared_ptr<Item> it = get_item(w, index);
-		if (it == nullptr) return false;
-		if (it->is_empty()) return false;
+		const Item it = get_item(w, index);
+		if (!it) return false;
+		if (it.is_empty()) return false;
 
-		if (it->is_dir()) {
-			const auto& p = it->path();
-			const auto path = (p.front() == L':') ? p : (it->is_link() ? link::resolve(p) : p);
+		if (it.is_dir()) {
+			const auto p = it.path();
+			const auto path = (p.front() == L':') ? p : (it.is_link() ? shortcut::resolve(p) : p);
 			set_current_directory(path);
 			return true;
 		}
-		if (link::is_link(it->path())) {  // If it is a shortcut
-			auto path = link::resolve(it->path());
+		if (shortcut::is_link(it.path())) {  // If it is a shortcut
+			auto path = shortcut::resolve(it.path());
 			path = path::parent(path);  // Get parent path
 			set_current_directory(path);
 			return true;
 		}
 		if (in_bookmark() || in_history()) {
-			auto path = path::parent(it->path());
+			auto path = path::parent(it.path());
 			set_current_directory(path);
 			return true;
 		}
@@ -211,11 +449,11 @@ public:
 
 	// Check if it is possible to move to lower folder
 	bool is_movable_to_lower(ListType w, size_t index) {
-		const std::shared_ptr<Item> it = get_item(w, index);
+		const Item it = get_item(w, index);
 
-		if (it == nullptr) return false;
-		if (it->is_empty()) return false;
-		return it->is_dir() || link::is_link(it->path()) || in_bookmark() || in_history();
+		if (!it) return false;
+		if (it.is_empty()) return false;
+		return it.is_dir() || shortcut::is_link(it.path()) || in_bookmark() || in_history();
 	}
 
 	// Set operators for multiple selected files
@@ -225,21 +463,21 @@ public:
 		const auto idx = index.value();
 
 		const auto& vec = (type == ListType::FILE) ? files_ : navis_;
-		const auto& it  = vec.at(idx);
+		const auto it   = vec.at(idx);
 		if (!it) return ope;
 
-		if (it->is_empty()) return ope;
+		if (it.is_empty()) return ope;
 
 		// When index is not selected (including hierarchy) -> Single file is selected alone
-		if (!it->is_sel()) {
-			ope.add(it->path());
+		if (!it.is_sel()) {
+			ope.add(it.path());
 			return ope;
 		}
 		// Copy selected file name
-		ope.add(it->path());  // Copy the file specified by index to the beginning
+		ope.add(it.path());  // Copy the file specified by index to the beginning
 		for (size_t i = 0; i < vec.size(); ++i) {
-			if (vec.at(i)->is_sel() && i != idx) {
-				ope.add(vec.at(i)->path());
+			if (vec.at(i).is_sel() && i != idx) {
+				ope.add(vec.at(i).path());
 			}
 		}
 		return ope;
@@ -260,16 +498,16 @@ public:
 	bool arrange_favorites(std::optional<size_t> drag, std::optional<size_t> drop) {
 		if (!drag || !drop || drag == drop) return false;
 		if (!in_bookmark()) return false;
-		return fav_.arrange(files_.at(drag.value())->id(), files_.at(drop.value())->id());
+		return fav_.arrange(files_.at(drag.value()).id(), files_.at(drop.value()).id());
 	}
 
 	// Add to / Remove from Favorites
 	void add_or_remove_favorite(const std::wstring& obj, ListType w, size_t index) {
 		auto &vec = (w == ListType::FILE) ? files_ : navis_;
 
-		if (vec.at(index)->is_empty()) return;
+		if (vec.at(index).is_empty()) return;
 		if (in_bookmark() && w == ListType::FILE) {
-			fav_.remove(files_.at(index)->id());
+			fav_.remove(files_.at(index).id());
 		} else {
 			fav_.add(obj);
 		}
@@ -291,14 +529,14 @@ public:
 		return files_.selected_size();
 	}
 
-	// The current directory is a bookmark
+	// The current directory is a bookmark (not while the files found in the index are shown)
 	bool in_bookmark() noexcept {
-		return cur_path_ == fav_.PATH;
+		return !subtree_ && cur_path_ == fav_.PATH;
 	}
 
-	// Current directory is history
+	// Current directory is history (not while the files found in the index are shown)
 	bool in_history() noexcept {
-		return cur_path_ == his_.PATH;
+		return !subtree_ && cur_path_ == his_.PATH;
 	}
 
 	// Current directory is drive
@@ -317,7 +555,7 @@ public:
 	}
 
 	// Return file information
-	std::shared_ptr<Item> get_item(ListType w, size_t index) {
+	Item get_item(ListType w, size_t index) {
 		return (w == ListType::FILE) ? files_.at(index) : navis_.at(index);
 	}
 
@@ -337,8 +575,13 @@ public:
 		return files_.size();
 	}
 
+	// Return the number of bytes allocated for the lists
+	size_t footprint() const noexcept {
+		return files_.footprint() + navis_.footprint();
+	}
+
 	bool is_file_empty() const {
-		return files_.size() && files_.at(0)->is_empty();
+		return files_.size() && files_.at(0).is_empty();
 	}
 
 };
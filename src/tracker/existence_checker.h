@@ -0,0 +1,168 @@
+/**
+ * Existence Checker (Attributes of Paths Probed in Parallel by Volume and Cached Shortly)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+
+#include "os.hpp"
+
+class ExistenceChecker {
+
+	inline static const uint64_t MAX_AGE     = 10 * 1000;  // Age of the attributes to be used [ms]
+	inline static const uint64_t TIMEOUT     = 1000;       // Time to wait for a volume to answer [ms]
+	inline static const size_t   MAX_ENTRIES = 4096;
+
+	struct Entry {
+		uint32_t attr;  // ATTR_INVALID when the path does not exist
+		uint64_t at;
+	};
+
+	// Paths waiting to be probed on a volume by its thread
+	struct Volume {
+		uint64_t since;  // When the path being probed was started
+		std::deque<std::wstring> paths;
+	};
+
+	// Shared with the probing threads, which are left running while a volume does not answer
+	struct State {
+		std::mutex mutex;
+		std::condition_variable cv;
+		std::unordered_map<std::wstring, Entry> es;
+		std::unordered_map<std::wstring, Volume> busy;  // Volumes being probed
+		bool changed{};
+		std::function<void()> notify;
+	};
+
+	std::shared_ptr<State> st_{ std::make_shared<State>() };
+
+	// Drive like 'C:' or share like '\\server\share' (the first folder otherwise)
+	static std::wstring volume_of(const std::wstring& path) {
+		if (path.size() >= 2 && path[1] == L':') return path.substr(0, 2);
+		const bool unc = path.starts_with(L"\\\\");
+		auto pos = path.find_first_of(L"\\/", unc ? 2 : 1);
+		if (unc && pos != std::wstring::npos) pos = path.find_first_of(L"\\/", pos + 1);
+		return path.substr(0, pos);
+	}
+
+	static bool find(const State& st, const std::wstring& path, uint32_t& attr) {
+		const auto it = st.es.find(path);
+		if (it == st.es.end() || os::tick_count() - it->second.at > MAX_AGE) return false;
+		attr = it->second.attr;
+		return true;
+	}
+
+	// Probe the paths queued on a volume one by one in a thread of its own until the queue becomes empty
+	static void start(std::shared_ptr<State> st, std::wstring vol) {
+		std::thread([st = std::move(st), vol = std::move(vol)] {
+			os::fail_critical_errors_in_thread();
+			while (true) {
+				std::wstring p;
+				std::function<void()> notify;
+				{
+					std::lock_guard lock(st->mutex);
+					auto& v = st->busy.at(vol);
+					if (v.paths.empty()) {
+						st->busy.erase(vol);
+						st->changed = true;
+						notify = st->notify;
+					} else {
+						p = std::move(v.paths.front());
+						v.paths.pop_front();
+						v.since = os::tick_count();
+					}
+				}
+				if (p.empty()) {
+					if (notify) notify();
+					return;
+				}
+				const auto attr = os::file_attributes(p);
+				{
+					std::lock_guard lock(st->mutex);
+					if (st->es.size() >= MAX_ENTRIES) st->es.clear();
+					st->es.insert_or_assign(p, Entry{ attr, os::tick_count() });
+				}
+				st->cv.notify_all();
+			}
+		}).detach();
+	}
+
+public:
+
+	ExistenceChecker() = default;
+	ExistenceChecker(const ExistenceChecker&) = delete;
+	ExistenceChecker& operator=(const ExistenceChecker&) = delete;
+	ExistenceChecker(ExistenceChecker&&) = delete;
+	ExistenceChecker& operator=(ExistenceChecker&&) = delete;
+
+	~ExistenceChecker() {
+		std::lock_guard lock(st_->mutex);
+		st_->notify = nullptr;
+	}
+
+	// Set the function called from a probing thread when a volume has answered
+	void set_notifier(std::function<void()> fn) {
+		std::lock_guard lock(st_->mutex);
+		st_->notify = std::move(fn);
+	}
+
+	// Get the attributes of the path probed recently
+	bool cached(const std::wstring& path, uint32_t& attr) const {
+		std::lock_guard lock(st_->mutex);
+		return find(*st_, path, attr);
+	}
+
+	// Probe the paths not probed recently in the background, in parallel by volume; the paths on a volume
+	// being probed are queued to its thread
+	void probe(const std::vector<std::wstring>& paths) {
+		std::vector<std::wstring> vols;
+		{
+			std::lock_guard lock(st_->mutex);
+			uint32_t attr;
+			for (const auto& p : paths) {
+				if (p.empty() || find(*st_, p, attr)) continue;
+				auto vol = volume_of(p);
+				auto [it, inserted] = st_->busy.try_emplace(vol, Volume{ os::tick_count(), {} });
+				auto& ps = it->second.paths;
+				if (std::find(ps.begin(), ps.end(), p) == ps.end()) ps.push_back(p);
+				if (inserted) vols.push_back(std::move(vol));
+			}
+		}
+		for (auto& vol : vols) start(st_, std::move(vol));
+	}
+
+	// Get the attributes of the path, waiting for its volume up to the timeout (returns false when it is not
+	// answered by then); a volume stuck on a path for the timeout is not waited for again until it answers
+	bool attributes(const std::wstring& path, uint32_t& attr) {
+		probe({ path });
+		const auto vol = volume_of(path);
+		std::unique_lock lock(st_->mutex);
+		const auto it = st_->busy.find(vol);
+		const bool stuck = it != st_->busy.end() && os::tick_count() - it->second.since >= TIMEOUT;
+		return st_->cv.wait_for(lock, std::chrono::milliseconds(stuck ? 0 : TIMEOUT), [&] { return find(*st_, path, attr); });
+	}
+
+	// Whether any volume has answered since this was called last
+	bool take_changed() {
+		std::lock_guard lock(st_->mutex);
+		const bool ret = st_->changed;
+		st_->changed = false;
+		return ret;
+	}
+
+};
@@ -2,17 +2,16 @@
  * File System Operations
  *
  * @author Takuto Yanagida
- * @version 2026-04-30
+ * @version 2026-10-17
  */
 
 #pragma once
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
-#include <FileAPI.h>
-#include <Shlobj.h>
-
+#include "os.hpp"
 #include "path.hpp"
 
 namespace file_system {
@@ -20,43 +19,37 @@ namespace file_system {
 	// Template version of find first file
 	template<typename F> bool find_first_file(const std::wstring& path, F fn) {
 		auto parent{ path };
-		parent += (parent.back() == path::PATH_SEPARATOR) ? L"*" : L"\\*";
-
-		WIN32_FIND_DATA wfd{};
-		auto sh = ::FindFirstFileEx(parent.c_str(), FindExInfoBasic, &wfd, FindExSearchNameMatch, nullptr, 0);
-		if (sh == INVALID_HANDLE_VALUE) return false;
-		parent.resize(parent.size() - 1);
-		do {
-			if (!::lstrcmp(&wfd.cFileName[0], L".") || !::lstrcmp(&wfd.cFileName[0], L"..")) continue;
-			if (!fn(parent, wfd)) break;
-		} while (::FindNextFile(sh, &wfd));
-		::FindClose(sh);
-		return true;
+		if (parent.back() != path::PATH_SEPARATOR) parent.append(1, path::PATH_SEPARATOR);
+
+		return os::find_files(parent, [&](const os::FindData& fd) {
+			if (fd.name == L"." || fd.name == L"..") return true;
+			return fn(parent, fd);
+		});
 	}
 
 	// Calculate file/directory size internally
-	bool calc_file_size_internally(const std::wstring& path, uint64_t& size, const uint64_t& limitTime) {
-		if (limitTime > 0 && ::GetTickCount64() > limitTime) return false;
+	inline bool calc_file_size_internally(const std::wstring& path, uint64_t& size, const uint64_t& limitTime) {
+		if (limitTime > 0 && os::tick_count() > limitTime) return false;
 		bool success = true;
 
-		find_first_file(path, [&](const std::wstring& parent, const WIN32_FIND_DATA& wfd) {
-			if (wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-				return success = calc_file_size_internally(parent + std::wstring{ &wfd.cFileName[0] }, size, limitTime);
+		find_first_file(path, [&](const std::wstring& parent, const os::FindData& fd) {
+			if (fd.attr & os::ATTR_DIRECTORY) {
+				return success = calc_file_size_internally(parent + std::wstring{ fd.name }, size, limitTime);
 			}
-			size += (static_cast<uint64_t>(wfd.nFileSizeHigh) << 32) + wfd.nFileSizeLow;
+			size += fd.size;
 			return true;
 		});
 		return success;
 	}
 
 	// Check whether there is an execution file that has the same name as the name of path
-	bool is_existing_same_name_execution_file(const std::wstring& path) {
+	inline bool is_existing_same_name_execution_file(const std::wstring& path) {
 		bool ret = false;
 		auto temp = path::parent(path);
 		if (temp.empty()) return false;  // path is root
 
-		find_first_file(temp, [&](const std::wstring&, const WIN32_FIND_DATA& wfd) {
-			auto e = path::ext(std::wstring{ &wfd.cFileName[0] });
+		find_first_file(temp, [&](const std::wstring&, const os::FindData& fd) {
+			auto e = path::ext(std::wstring{ fd.name });
 			if (e == L"exe" || e == L"bat") {
 				ret = true;
 				return false;  // break;
@@ -67,59 +60,38 @@ namespace file_system {
 	}
 
 	// Check whether the path is a removable disk
-	bool is_removable(const std::wstring& path) noexcept {
-		return ::GetDriveType(path.c_str()) == DRIVE_REMOVABLE;
+	inline bool is_removable(const std::wstring& path) noexcept {
+		return os::is_removable(path);
 	}
 
 	// Check whether the path is a directory
-	bool is_directory(const std::wstring& path) noexcept {
-		const auto attr = ::GetFileAttributes(path::ensure_unc_prefix(path).c_str());
-		return (attr & FILE_ATTRIBUTE_DIRECTORY) != 0;
+	inline bool is_directory(const std::wstring& path) noexcept {
+		const auto attr = os::file_attributes(path);
+		return (attr & os::ATTR_DIRECTORY) != 0;
 	}
 
 	// Check whether the file of the path is existing
-	bool is_existing(const std::wstring& path) noexcept {
-		const auto attr = ::GetFileAttributes(path::ensure_unc_prefix(path).c_str());
-		return attr != INVALID_FILE_ATTRIBUTES;
+	inline bool is_existing(const std::wstring& path) noexcept {
+		return os::file_attributes(path) != os::ATTR_INVALID;
 	}
 
 	// Get desktop directory path
-	std::wstring desktop_path() {
-		std::wstring ret;
-		PWSTR buf = nullptr;
-		if (::SHGetKnownFolderPath(FOLDERID_Desktop, 0, nullptr, &buf) == S_OK) {
-			ret.assign(buf);
-			::CoTaskMemFree(buf);
-		}
-		return ret;
+	inline std::wstring desktop_path() {
+		return os::desktop_path();
 	}
 
 	// Get the exe file path
-	std::wstring module_file_path() noexcept {
-		std::vector<wchar_t> buf(MAX_PATH);
-		for (DWORD nSize = MAX_PATH;; nSize *= 2) {
-			buf.resize(nSize);
-			const auto len = ::GetModuleFileName(nullptr, buf.data(), nSize);
-			if (::GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
-				return std::wstring(buf.data(), len);
-			}
-		}
+	inline std::wstring module_file_path() {
+		return os::module_file_path();
 	}
 
 	// Get the current directory path
-	std::wstring current_directory_path() {
-		std::vector<wchar_t> buf(MAX_PATH);
-		for (DWORD nSize = MAX_PATH;;) {
-			buf.resize(nSize);
-			nSize = ::GetCurrentDirectory(nSize, buf.data());
-			if (nSize < buf.size()) {
-				return std::wstring(buf.data());
-			}
-		}
+	inline std::wstring current_directory_path() {
+		return os::current_directory_path();
 	}
 
 	// Make unique new name
-	std::wstring unique_name(const std::wstring& obj, const std::wstring& post = std::wstring()) {
+	inline std::wstring unique_name(const std::wstring& obj, const std::wstring& post = std::wstring()) {
 		if (path::is_root(obj)) return L"";  // Failure
 		const auto parent = path::parent(obj);
 		auto name = path::name(obj);
@@ -143,31 +115,20 @@ namespace file_system {
 	}
 
 	// Get drive size
-	void drive_size(const std::wstring& path, uint64_t& size, uint64_t& free) noexcept {
-		ULARGE_INTEGER f{}, s{};
-		::GetDiskFreeSpaceEx(path.c_str(), &f, &s, nullptr);
-		free = f.QuadPart;
-		size = s.QuadPart;
+	inline void drive_size(const std::wstring& path, uint64_t& size, uint64_t& free) noexcept {
+		os::drive_size(path, size, free);
 	}
 
 	// Calculate file/directory size
-	bool calc_file_size(const std::wstring& path, uint64_t& size, const uint64_t& limitTime) {
+	inline bool calc_file_size(const std::wstring& path, uint64_t& size, const uint64_t& limitTime) {
 		if (!is_directory(path)) {
-			auto hf = ::CreateFile(path.c_str(), 0, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_BACKUP_SEMANTICS, nullptr);
-			if (hf == INVALID_HANDLE_VALUE) {
-				return false;
-			}
-			LARGE_INTEGER s{};
-			::GetFileSizeEx(hf, &s);
-			size = s.QuadPart;
-			::CloseHandle(hf);
-			return true;
+			return os::file_size(path, size);
 		}
 		size = 0;
 		return calc_file_size_internally(path, size, limitTime);
 	}
 
-	bool calc_file_size(const std::vector<std::wstring>& paths, uint64_t& size, const uint64_t& limitTime) {
+	inline bool calc_file_size(const std::vector<std::wstring>& paths, uint64_t& size, const uint64_t& limitTime) {
 		size = 0;
 		for (const auto& p : paths) {
 			uint64_t s{};
@@ -178,7 +139,7 @@ namespace file_system {
 	}
 
 	// Extract command line string (path|opt)
-	std::pair<std::wstring, std::wstring> extract_command_line_string(const std::wstring& line, const std::vector<std::wstring>& objs) {
+	inline std::pair<std::wstring, std::wstring> extract_command_line_string(const std::wstring& line, const std::vector<std::wstring>& objs) {
 		const auto sep = line.find_first_of(L'|');
 		if (sep == std::wstring::npos) {
 			return { path::absolute_path(line, file_system::module_file_path()), path::space_separated_quoted_paths_string(objs) };
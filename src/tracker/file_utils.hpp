@@ -4,7 +4,7 @@
 #include "error_mode.hpp"
 #include "file_system.hpp"
 #include "shell.hpp"
-#include "link.hpp"
+#include "shortcut.hpp"
 #include "operation.hpp"
 #include "file_drag.hpp"
 #include "clipboard.hpp"
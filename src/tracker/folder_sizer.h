@@ -0,0 +1,125 @@
+/**
+ * Folder Sizer (Background Calculation of Total Sizes of Listed Folders)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <stop_token>
+#include <cstdint>
+
+#include "os.hpp"
+#include "size_calculator.h"
+
+class FolderSizer {
+
+	inline static const uint64_t NOTIFY_INTERVAL = 100;  // Minimum interval of notifications [ms]
+
+public:
+
+	using Sizes = std::vector<std::pair<uint32_t, uint64_t>>;  // Rows and their sizes
+
+private:
+
+	// Shared with the calculation, which is left to stop by itself when it is canceled
+	struct State {
+		std::mutex mutex;
+		Sizes pending;
+		bool posted{};
+		uint64_t last{};
+		uint64_t gen{};  // Generation of the calculation whose sizes are taken
+		std::function<void()> notify;
+	};
+
+	std::shared_ptr<State> st_{ std::make_shared<State>() };
+	std::stop_source stop_;
+
+	// Calculate the sizes of the folders by one pool of workers, passing them on at intervals
+	static void run(std::shared_ptr<State> st, uint64_t gen, std::stop_token stop, std::vector<std::pair<uint32_t, std::wstring>> dirs) {
+		os::fail_critical_errors_in_thread();
+		std::vector<std::wstring> paths;
+		paths.reserve(dirs.size());
+		for (const auto& d : dirs) paths.push_back(d.second);
+		size_t left = dirs.size();
+
+		SizeCalculator calc;
+		calc.calc_each(paths, [&](size_t i, uint64_t size) {
+			std::function<void()> notify;
+			{
+				std::lock_guard lock(st->mutex);
+				if (st->gen != gen) return;
+				st->pending.emplace_back(dirs[i].first, size);
+				const bool last = --left == 0;  // Counted also while a notification is outstanding
+				const auto now  = os::tick_count();
+				if (!st->posted && (last || now - st->last >= NOTIFY_INTERVAL)) {
+					st->posted = true;
+					st->last   = now;
+					notify     = st->notify;
+				}
+			}
+			if (notify) notify();
+		}, sort_engine::thread_count(), stop);
+	}
+
+public:
+
+	FolderSizer() noexcept = default;
+	FolderSizer(const FolderSizer&) = delete;
+	FolderSizer& operator=(const FolderSizer&) = delete;
+	FolderSizer(FolderSizer&&) = delete;
+	FolderSizer& operator=(FolderSizer&&) = delete;
+
+	~FolderSizer() {
+		cancel();
+		std::lock_guard lock(st_->mutex);
+		st_->notify = nullptr;
+	}
+
+	// Set the function called from a worker when calculated sizes are ready to be taken
+	void set_notifier(std::function<void()> fn) {
+		std::lock_guard lock(st_->mutex);
+		st_->notify = std::move(fn);
+	}
+
+	// Start calculating the sizes of the folders of the rows, the first first (the previous calculation is
+	// canceled); sizes of the folders not changed recently come from the shared size cache
+	void start(std::vector<std::pair<uint32_t, std::wstring>> dirs) {
+		cancel();
+		if (dirs.empty()) return;
+		uint64_t gen;
+		{
+			std::lock_guard lock(st_->mutex);
+			st_->posted = false;
+			st_->last   = os::tick_count();
+			gen = st_->gen;
+		}
+		stop_ = std::stop_source{};
+		std::thread(run, st_, gen, stop_.get_token(), std::move(dirs)).detach();
+	}
+
+	// Stop the current calculation without waiting for it and discard the sizes not taken
+	void cancel() {
+		stop_.request_stop();
+		std::lock_guard lock(st_->mutex);
+		++st_->gen;
+		st_->pending.clear();
+	}
+
+	// Take the sizes calculated so far
+	void take(Sizes& out) {
+		out.clear();
+		std::lock_guard lock(st_->mutex);
+		std::swap(out, st_->pending);
+		st_->posted = false;
+	}
+
+};
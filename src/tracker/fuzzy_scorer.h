@@ -0,0 +1,174 @@
+/**
+ * Fuzzy Scorer (Ranking Names Containing the Characters of a Word in Order)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cwctype>
+#include <cstdint>
+
+class FuzzyScorer {
+
+	// Scores like those of fzf; a match gains more at the head of a name, of a word and of the extension,
+	// and loses by the gaps between the matched characters
+	inline static const int SCORE_MATCH       = 16;
+	inline static const int GAP_START         = -3;
+	inline static const int GAP_EXTENSION     = -1;
+	inline static const int BONUS_HEAD        = 10;
+	inline static const int BONUS_BOUNDARY    = 8;
+	inline static const int BONUS_CAMEL       = 7;
+	inline static const int BONUS_CONSECUTIVE = 4;
+	inline static const int FIRST_MULTIPLIER  = 2;
+	inline static const int NONE              = -(1 << 20);
+
+	inline static const size_t MAX_WORD = 64;
+	inline static const size_t MAX_NAME = 1024;
+
+	std::wstring word_;  // Folded
+	uint64_t     mask_{};
+
+	mutable std::wstring     buf_;  // Folded name
+	mutable std::vector<int> bonus_, h_, c_, ph_, pc_;
+
+	static wchar_t fold(wchar_t c) noexcept {
+		if (c < 0x80) return (L'A' <= c && c <= L'Z') ? static_cast<wchar_t>(c | 0x20) : c;
+		return static_cast<wchar_t>(std::towlower(c));
+	}
+
+	static uint64_t bit(wchar_t c) noexcept {
+		if (L'a' <= c && c <= L'z') return uint64_t{ 1 } << (c - L'a');
+		if (L'0' <= c && c <= L'9') return uint64_t{ 1 } << (26 + c - L'0');
+		return uint64_t{ 1 } << (36 + c % 28);
+	}
+
+	static bool is_delimiter(wchar_t c) noexcept {
+		return c == L' ' || c == L'_' || c == L'-' || c == L'.' || c == L'(' || c == L')' || c == L'[' || c == L']' || c == 0x3000;
+	}
+
+	static int bonus(std::wstring_view name, size_t i, size_t ext) noexcept {
+		if (i == 0) return BONUS_HEAD;
+		if (i == ext || is_delimiter(name[i - 1])) return BONUS_BOUNDARY;
+		const wchar_t p = name[i - 1], c = name[i];
+		if (p < 0x80 && c < 0x80) {
+			if (L'a' <= p && p <= L'z' && L'A' <= c && c <= L'Z') return BONUS_CAMEL;
+			if (!(L'0' <= p && p <= L'9') && L'0' <= c && c <= L'9') return BONUS_CAMEL;
+			return 0;
+		}
+		if (std::iswlower(p) && std::iswupper(c)) return BONUS_CAMEL;
+		if (!std::iswdigit(p) && std::iswdigit(c)) return BONUS_CAMEL;
+		return 0;
+	}
+
+public:
+
+	FuzzyScorer() noexcept = default;
+	FuzzyScorer(const FuzzyScorer&) = delete;
+	FuzzyScorer& operator=(const FuzzyScorer&) = delete;
+	FuzzyScorer(FuzzyScorer&&) = delete;
+	FuzzyScorer& operator=(FuzzyScorer&&) = delete;
+	~FuzzyScorer() = default;
+
+	void set_word(std::wstring_view word) {
+		word_.clear();
+		for (const wchar_t c : word) word_.push_back(fold(c));
+		mask_ = mask_of(word_);
+	}
+
+	// Mask of the characters of the name folded, made once for each name; names whose masks lack some
+	// characters of the word are not scored
+	static uint64_t mask_of(std::wstring_view name) noexcept {
+		static const auto ascii = [] {
+			std::array<uint64_t, 0x80> t{};
+			for (wchar_t c = 0; c < 0x80; ++c) t[c] = bit(fold(c));
+			return t;
+		}();
+		uint64_t m = 0;
+		for (const wchar_t c : name) m |= (c < 0x80) ? ascii[c] : bit(fold(c));
+		return m;
+	}
+
+	bool empty() const noexcept {
+		return word_.empty();
+	}
+
+	// Score of the name with its mask (0 when it does not contain the characters of the word in order)
+	int score(std::wstring_view name, uint64_t mask = ~uint64_t{}) const {
+		if (word_.empty()) return 1;
+		const size_t m = word_.size();
+		if (name.size() < m || (mask & mask_) != mask_) return 0;
+
+		// Prefilter by the characters in order in a pass without copying, which most names fail
+		size_t first = 0;
+		for (size_t i = 0, j = 0; ; ++j) {
+			if (j == name.size()) return 0;
+			if (fold(name[j]) != word_[i]) continue;
+			if (i == 0) first = j;
+			if (++i == m) break;
+		}
+		if (m > MAX_WORD || name.size() > MAX_NAME) return static_cast<int>(m) * SCORE_MATCH;
+		const size_t dot = name.rfind(L'.');
+		const size_t ext = (dot == std::wstring_view::npos) ? 0 : dot + 1;
+
+		if (m == 1) {  // The best of the single matches, of which that at the head is the best
+			int b = (first == 0) ? BONUS_HEAD : 0;
+			for (size_t j = first; j < name.size() && b < BONUS_HEAD; ++j) {
+				if (fold(name[j]) == word_[0]) b = (std::max)(b, bonus(name, j, ext));
+			}
+			return SCORE_MATCH + b * FIRST_MULTIPLIER;
+		}
+		size_t last = name.size();  // The range to score
+		while (fold(name[last - 1]) != word_.back()) --last;
+		buf_.resize(last);
+		bonus_.resize(last);
+		for (size_t j = first; j < last; ++j) {
+			buf_[j]   = fold(name[j]);
+			bonus_[j] = (bit(buf_[j]) & mask_) ? bonus(name, j, ext) : 0;  // Only where the word can match
+		}
+		const std::wstring_view s{ buf_ };
+
+		// Best scores of matching the word up to i within the name up to j, and the lengths of consecutive matches
+		// (each row is written from first + i, where the next row starts reading)
+		h_.resize(last);
+		c_.resize(last);
+		ph_.resize(last);
+		pc_.resize(last);
+		int best = NONE;
+		for (size_t i = 0; i < m; ++i) {
+			ph_.swap(h_);
+			pc_.swap(c_);
+			int  left   = NONE;  // Score at j - 1
+			bool in_gap = false;
+			for (size_t j = first + i; j < last; ++j) {
+				const int gap = (left != NONE) ? left + (in_gap ? GAP_EXTENSION : GAP_START) : NONE;
+				int match = NONE, run = 0;
+				if (s[j] == word_[i] && (i == 0 || ph_[j - 1] != NONE)) {
+					int b = bonus_[j];
+					run = (i == 0) ? 1 : pc_[j - 1] + 1;
+					if (run > 1) b = (std::max)({ b, BONUS_CONSECUTIVE, bonus_[j - run + 1] });
+					match = (i == 0) ? SCORE_MATCH + b * FIRST_MULTIPLIER : ph_[j - 1] + SCORE_MATCH + b;
+				}
+				if (match != NONE && match >= gap) {
+					left   = match;
+					c_[j]  = run;
+					in_gap = false;
+				} else {
+					left   = gap;
+					c_[j]  = 0;
+					in_gap = gap != NONE;
+				}
+				h_[j] = left;
+				if (i == m - 1 && match > best) best = match;
+			}
+		}
+		return (std::max)(best, 1);
+	}
+
+};
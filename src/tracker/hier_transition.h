@@ -2,12 +2,13 @@
  * Transition of Folder Hierarchy
  *
  * @author Takuto Yanagida
- * @version 2025-11-19
+ * @version 2026-10-17
  */
 
 #pragma once
 
 #include <vector>
+#include <string>
 
 class HierTransition {
 
@@ -2,7 +2,7 @@
  * History
  *
  * @author Takuto Yanagida
- * @version 2026-04-30
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -11,7 +11,10 @@
 #include <string>
 #include <algorithm>
 
-#include "file_utils.hpp"
+#include "tracker.h"
+#include "path.hpp"
+#include "file_system.hpp"
+#include "existence_checker.h"
 #include "pref.hpp"
 #include "text_reader_writer.hpp"
 
@@ -27,7 +30,7 @@ public:
 
 	inline static const std::wstring PATH{ L":HISTORY" }, NAME{ L"History" };
 
-	History(const std::wstring& iniPath) noexcept : path_(path::parent(iniPath).append(L"\\").append(FILE_NAME)) {}
+	History(const std::wstring& iniPath) noexcept : path_(path::parent(iniPath).append(1, path::PATH_SEPARATOR).append(FILE_NAME)) {}
 
 	void initialize(Pref& pref) noexcept {
 		max_size_ = pref.item_int(KEY_MAX_HISTORY, VAL_MAX_HISTORY);
@@ -64,16 +67,17 @@ public:
 		}
 	}
 
-	void clean_up() {
-		// Delete a nonexistent path
+	// Delete the paths known not to exist; the others not probed recently are probed in the background
+	void clean_up(ExistenceChecker& checker) {
 		paths_.erase(
 			std::remove_if(
 				paths_.begin(),
 				paths_.end(),
-				[](const std::wstring& p) noexcept { return !file_system::is_existing(p); }
+				[&](const std::wstring& p) { uint32_t attr; return checker.cached(p, attr) && attr == os::ATTR_INVALID; }
 			),
 			paths_.end()
 		);
+		checker.probe(paths_);
 	}
 
 	void clear() noexcept {
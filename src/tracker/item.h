@@ -2,207 +2,101 @@
  * File Item
  *
  * @author Takuto Yanagida
- * @version 2026-04-30
+ * @version 2026-10-17
  */
 
 #pragma once
 
-#include <windows.h>
 #include <string>
-#include <vector>
-#include <memory>
+#include <string_view>
+#include <cstdint>
 
-#include "file_utils.hpp"
-#include "type_table.h"
+#include "directory_snapshot.h"
 
+// Lightweight handle to a row of a directory snapshot
 class Item {
 
-	inline static const std::wstring EMPTY_STR{ L"empty" };
+	const DirectorySnapshot* snap_{};
+	size_t row_{};
+	bool sel_{};
 
-	inline static const std::wstring EXT_FOLDER{ L"<folder>" };
-
-	inline static std::vector<std::shared_ptr<Item>> cache_;
-
-public:
-
-	static std::shared_ptr<Item> create() {
-		if (cache_.empty()) return std::make_shared<Item>();
-		auto it = cache_.back();
-		cache_.pop_back();
-		return it;
-	}
-
-	static void destroy(std::shared_ptr<Item> it) {
-		it->clear();
-		cache_.push_back(it);
-	}
-
-private:
-
-	enum { DIR = 2, HIDE = 4, LINK = 8, HIER = 16, SEL = 32, EMPTY = 64 };
-
-	std::wstring path_{};
-	std::wstring name_{};
-	FILETIME time_{};
-	unsigned long long size_{};
-
-	int color_{};
-	int style_{};
-	int data_{};
-	size_t id_{};
-
-	void clear() noexcept {
-		path_.clear();
-		name_.clear();
-		time_.dwLowDateTime = 0;
-		time_.dwHighDateTime = 0;
-		size_ = 0UL;
-
-		style_ = 0;
-		color_ = 0;
-		data_ = 0;
-		id_ = 0;
-	}
-
-	void check_file(bool is_dir, bool is_hidden, const TypeTable& exts) {
-		auto ext = path::ext(name_);  // Get extension
-		style_ = 0;
-		if (!is_dir && ext == L"lnk") {  // When it is a link
-			name_.resize(name_.size() - 4);  // remove .lnk
-			auto link_path  = link::resolve(path_);
-			const auto attr = ::GetFileAttributes(path::ensure_unc_prefix(path_).c_str());
-
-			if (attr == INVALID_FILE_ATTRIBUTES) {  // When the link is broken
-				style_ = LINK | HIDE;
-				color_ = -1;
-				return;
-			}
-			is_dir = (attr & FILE_ATTRIBUTE_DIRECTORY) != 0;
-			if (!is_dir) ext = path::ext(link_path);  // Acquisition of extension of link destination
-			style_ = LINK;
-		}
-		style_ |= (is_dir ? DIR : 0) | (is_hidden ? HIDE : 0);
-		color_ = exts.get_color(is_dir ? EXT_FOLDER : ext);
+	bool has(uint8_t flag) const noexcept {
+		return (snap_->style(row_) & flag) != 0;
 	}
 
 public:
 
 	Item() noexcept = default;
-	Item(const Item&) = delete;
-	Item& operator=(const Item&) = delete;
-	Item(Item&&) = delete;
-	Item& operator=(Item&&) = delete;
-	~Item() = default;
-
-	void set_file(const std::wstring& parent_path, const WIN32_FIND_DATA& wfd, const TypeTable& exts) {
-		// parentPath must include \ at the end
-		const std::wstring file_name{ &wfd.cFileName[0] };
-		path_ = parent_path + file_name;
-		name_ = file_name;
-		time_ = wfd.ftLastWriteTime;
-		size_ = (static_cast<unsigned long long>(wfd.nFileSizeHigh) << 32) | wfd.nFileSizeLow;
+	Item(const DirectorySnapshot* snap, size_t row, bool sel = false) noexcept : snap_(snap), row_(row), sel_(sel) {}
 
-		const auto is_dir    = (wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-		const auto is_hidden = (wfd.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN)    != 0;
-
-		check_file(is_dir, is_hidden, exts);
+	explicit operator bool() const noexcept {
+		return snap_ != nullptr;
 	}
 
-	void set_file(const std::wstring& path, const TypeTable& exts, size_t id = 0) {
-		path_ = path;
-		name_ = path::name(path_);
-		id_   = id;
-
-		const auto attr = ::GetFileAttributes(path::ensure_unc_prefix(path_).c_str());
-		auto is_dir     = (attr & FILE_ATTRIBUTE_DIRECTORY) != 0;
-		auto is_hidden  = (attr & FILE_ATTRIBUTE_HIDDEN) != 0;
-
-		// When there is no file
-		if (attr == INVALID_FILE_ATTRIBUTES) {
-			is_dir    = false;
-			is_hidden = true;
-		}
-		// Measures to prevent drive from appearing as hidden file
-		if (path::is_root(path_)) is_hidden = false;
-
-		check_file(is_dir, is_hidden, exts);  // File item check
+	size_t row() const noexcept {
+		return row_;
 	}
 
-	void set_empty() {
-		path_.clear();
-		name_  = EMPTY_STR;
-		style_ = EMPTY;
-	}
+	// ----
 
-	void set_special(const std::wstring& path, const std::wstring& name) {
-		path_  = path;
-		name_  = name;
-		style_ = DIR;
-		color_ = ::GetSysColor(COLOR_GRAYTEXT);
+	std::wstring path() const {
+		return snap_->path(row_);
 	}
 
-	// ----
-
-	const std::wstring& path() const noexcept {
-		return path_;
+	// The name is always followed by '\0'
+	std::wstring_view name() const noexcept {
+		return snap_->name(row_);
 	}
 
-	const std::wstring& name() const noexcept {
-		return name_;
+	// Mask of the characters of the name for fuzzy matching
+	uint64_t char_mask() const noexcept {
+		return snap_->char_mask(row_);
 	}
 
-	const FILETIME& time() const noexcept {
-		return time_;
+	uint64_t time() const noexcept {
+		return snap_->time(row_);
 	}
 
 	unsigned long long size() const noexcept {
-		return size_;
+		return snap_->size(row_);
 	}
 
 	// ----
 
 	int color() const noexcept {
-		return color_;
+		return snap_->color(row_);
 	}
 
 	bool is_link() const noexcept {
-		return (style_ & LINK) != 0;
+		return has(DirectorySnapshot::LINK);
 	}
 
 	bool is_dir() const noexcept {
-		return (style_ & DIR) != 0;
+		return has(DirectorySnapshot::DIR);
 	}
 
 	bool is_hidden() const noexcept {
-		return (style_ & HIDE) != 0;
+		return has(DirectorySnapshot::HIDE);
 	}
 
 	bool is_hier() const noexcept {
-		return (style_ & HIER) != 0;
-	}
-
-	void set_sel(bool f) noexcept {
-		f ? (style_ |= SEL) : (style_ &= ~SEL);
+		return has(DirectorySnapshot::HIER);
 	}
 
 	bool is_sel() const noexcept {
-		return (style_ & SEL) != 0;
+		return sel_;
 	}
 
 	bool is_empty() const noexcept {
-		return (style_ & EMPTY) != 0;
-	}
-
-	int& data() noexcept {
-		return data_;
+		return has(DirectorySnapshot::EMPTY);
 	}
 
-	const int& data() const noexcept {
-		return data_;
+	int data() const noexcept {
+		return snap_->data(row_);
 	}
 
 	size_t id() const noexcept {
-		return id_;
+		return snap_->id(row_);
 	}
 
 };
@@ -2,23 +2,54 @@
  * Item list
  *
  * @author Takuto Yanagida
- * @version 2026-04-30
+ * @version 2026-10-17
  */
 
 #pragma once
 
 #include <vector>
-#include <memory>
 #include <utility>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <cstdint>
 
+#include "directory_snapshot.h"
 #include "item.h"
 #include "comparator.h"
+#include "sort_engine.hpp"
 
 class ItemList {
 
-	std::vector<std::shared_ptr<Item>> its_;
+	DirectorySnapshot snap_;
+	std::vector<uint32_t> order_;  // Display order of the rows of snap_
+	std::vector<uint8_t> sel_;     // Selection state by row
 	size_t sel_size_{};
 
+	int sorted_by_{ -1 };  // Sort applied to order_ since it last changed (-1 when not sorted)
+	bool sorted_rev_{};
+
+	std::vector<uint32_t> all_;  // Display order of all the rows while order_ is filtered
+	std::function<bool(const Item&)> filter_;
+
+	template<bool Radix, typename C> static void sort_rows(std::vector<uint32_t>& rows, const C& cmp) {
+		if constexpr (Radix) {
+			sort_engine::radix_sort_by(rows, cmp);
+		} else {
+			sort_engine::parallel_sort(rows, cmp);
+		}
+	}
+
+	template<bool Radix, typename C> void sort_by(const C& cmp) {
+		sort_rows<Radix>(order_, cmp);
+		if (filter_) sort_rows<Radix>(all_, cmp);
+	}
+
+	void reset_filter() noexcept {
+		all_.clear();
+		filter_ = nullptr;
+	}
+
 public:
 
 	ItemList() noexcept = default;
@@ -29,56 +60,220 @@ public:
 	~ItemList() = default;
 
 	size_t size() const noexcept {
-		return its_.size();
+		return order_.size();
 	}
 
-	std::shared_ptr<Item> at(size_t idx) {
-		return its_.at(idx);
+	size_t capacity() const noexcept {
+		return order_.capacity();
 	}
 
-	const std::shared_ptr<Item> at(size_t idx) const {
-		return its_.at(idx);
+	Item at(size_t idx) const {
+		const auto row = order_.at(idx);
+		return { &snap_, row, sel_[row] != 0 };
 	}
 
-	void add(std::shared_ptr<Item> it) {
-		its_.emplace_back(std::move(it));
+	// Snapshot to which rows are added before they are placed by add or insert
+	DirectorySnapshot& snapshot() noexcept {
+		return snap_;
 	}
 
-	void insert(size_t index, std::shared_ptr<Item> it) {
-		its_.emplace(its_.begin() + index, std::move(it));
+	const DirectorySnapshot& snapshot() const noexcept {
+		return snap_;
+	}
+
+	void add(size_t row) {
+		sel_.resize(snap_.size());
+		sorted_by_ = -1;
+		if (filter_) {
+			all_.push_back(static_cast<uint32_t>(row));
+			if (!filter_({ &snap_, row, false })) return;
+		}
+		order_.push_back(static_cast<uint32_t>(row));
 	}
 
-	void clear() {
-		for (auto& it : its_) {
-			Item::destroy(it);
+	void insert(size_t index, size_t row) {
+		sel_.resize(snap_.size());
+		sorted_by_ = -1;
+		if (filter_) {
+			all_.push_back(static_cast<uint32_t>(row));
+			if (!filter_({ &snap_, row, false })) return;
 		}
-		its_.clear();
+		order_.insert(order_.begin() + index, static_cast<uint32_t>(row));
+	}
+
+	// Replace the items with all the rows of the snapshot in their order
+	void assign(DirectorySnapshot&& snap) {
+		snap_ = std::move(snap);
+		order_.resize(snap_.size());
+		std::iota(order_.begin(), order_.end(), uint32_t{ 0 });
+		sel_.assign(snap_.size(), uint8_t{ 0 });
+		sel_size_  = 0;
+		sorted_by_ = -1;
+		reset_filter();
+	}
+
+	// Take out the snapshot and remove all items
+	DirectorySnapshot release() {
+		DirectorySnapshot ret{ std::move(snap_) };
+		snap_ = DirectorySnapshot{};
+		order_.clear();
+		sel_.clear();
+		sel_size_  = 0;
+		sorted_by_ = -1;
+		reset_filter();
+		return ret;
+	}
+
+	void clear() noexcept {
+		snap_.clear();
+		order_.clear();
+		sel_.clear();
+		sel_size_  = 0;
+		sorted_by_ = -1;
+		reset_filter();
+	}
+
+	// Remove all items and release capacity beyond the given numbers of items and characters
+	void trim(size_t items, size_t chars) {
+		snap_.trim(items, chars);
+		order_.clear();
+		sel_.clear();
+		sel_size_  = 0;
+		sorted_by_ = -1;
+		reset_filter();
+		all_.shrink_to_fit();
+		if (order_.capacity() > items) {
+			std::vector<uint32_t> o;
+			o.reserve(items);
+			order_.swap(o);
+			std::vector<uint8_t> s;
+			s.reserve(items);
+			sel_.swap(s);
+		}
+	}
+
+	// Number of bytes allocated for the items
+	size_t footprint() const noexcept {
+		return snap_.footprint() + (order_.capacity() + all_.capacity()) * sizeof(uint32_t) + sel_.capacity() * sizeof(uint8_t);
 	}
 
+	// Sort the items; when only the direction changes, the current order is just reversed
 	void sort(const int by, const bool reverse) {
-		auto proj = [](auto const& sp) noexcept { return sp.get(); };
-		auto sort_by = [&](auto cmp) {
-			std::ranges::sort(its_, cmp, proj);
-		};
+		if (by == sorted_by_) {
+			if (reverse != sorted_rev_) {
+				std::reverse(order_.begin(), order_.end());
+				if (filter_) std::reverse(all_.begin(), all_.end());
+			}
+			sorted_rev_ = reverse;
+			return;
+		}
+		if (by != 2) snap_.prepare_keys();
 		switch (by) {
-		case 0: sort_by(CompByName(reverse)); break;
-		case 1: sort_by(CompByType(reverse)); break;
-		case 2: sort_by(CompByDate(reverse)); break;
-		case 3: sort_by(CompBySize(reverse)); break;
-		default: break;
+		case 0: sort_by<false>(CompByName(snap_, reverse)); break;
+		case 1: sort_by<false>(CompByType(snap_, reverse)); break;
+		case 2: sort_by<true>(CompByDate(snap_, reverse)); break;
+		case 3: sort_by<true>(CompBySize(snap_, reverse)); break;
+		default: return;
+		}
+		sorted_by_  = by;
+		sorted_rev_ = reverse;
+	}
+
+	// Set the sizes calculated later; when sorted by sizes, only the rows changed are sorted and merged again
+	void set_sizes(const std::vector<std::pair<uint32_t, uint64_t>>& sizes) {
+		std::vector<uint32_t> rows;
+		for (const auto& [row, size] : sizes) {
+			if (snap_.size(row) == size) continue;
+			snap_.set_size(row, size);
+			rows.push_back(row);
 		}
+		if (rows.empty() || sorted_by_ != 3) return;
+		if (rows.size() > order_.size() / 8) {  // Sorting all is faster then
+			sorted_by_ = -1;
+			sort(3, sorted_rev_);
+			return;
+		}
+		const CompBySize cmp(snap_, sorted_rev_);
+		std::vector<uint8_t> changed(snap_.size());
+		for (const auto row : rows) changed[row] = 1;
+
+		// The rows changed are taken out, sorted and merged into the rest, which stay sorted
+		const auto place = [&](std::vector<uint32_t>& rs) {
+			std::vector<uint32_t> ms;
+			for (const auto row : rs) {
+				if (changed[row]) ms.push_back(row);
+			}
+			std::erase_if(rs, [&](uint32_t row) { return changed[row] != 0; });
+			std::stable_sort(ms.begin(), ms.end(), cmp);
+			const auto mid = rs.size();
+			rs.insert(rs.end(), ms.begin(), ms.end());
+			std::inplace_merge(rs.begin(), rs.begin() + static_cast<ptrdiff_t>(mid), rs.end(), cmp);
+		};
+		place(order_);
+		if (filter_) place(all_);
+	}
+
+	// Show only the items matching the filter; when it matches a subset of what the current filter matches,
+	// only the items shown now are checked (append-only narrowing)
+	void filter(std::function<bool(const Item&)> f, bool narrow) {
+		if (!filter_) {
+			all_ = order_;
+		} else if (!narrow) {
+			order_ = all_;
+		}
+		filter_ = std::move(f);
+		std::erase_if(order_, [&](uint32_t row) { return !filter_({ &snap_, row, false }); });
+	}
+
+	// Show only the items scored above zero in the descending order of the scores, keeping the current order
+	// for ties; items added later are shown at the end when they are scored above zero
+	void rank(std::function<int(const Item&)> score, bool narrow) {
+		if (!filter_) {
+			all_ = order_;
+		} else if (!narrow) {
+			order_ = all_;
+		}
+		// Rows are scored in the order of the snapshot, which reads its memory in sequence, and taken in the
+		// current order then
+		snap_.prepare_masks();
+		std::vector<int> scores(snap_.size());
+		for (const auto row : order_) scores[row] = 1;
+		for (size_t row = 0; row < scores.size(); ++row) {
+			if (scores[row]) scores[row] = score({ &snap_, row, false });
+		}
+		std::vector<std::pair<int, uint32_t>> ss;
+		ss.reserve(order_.size());
+		for (const auto row : order_) {
+			if (scores[row] > 0) ss.emplace_back(scores[row], row);
+		}
+		std::stable_sort(ss.begin(), ss.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+		order_.clear();
+		for (const auto& [s, row] : ss) order_.push_back(row);
+		filter_    = [score = std::move(score)](const Item& it) { return score(it) > 0; };
+		sorted_by_ = -1;
+	}
+
+	// Show all the items again in the current order
+	void unfilter() {
+		if (!filter_) return;
+		order_.swap(all_);
+		reset_filter();
+	}
+
+	bool is_filtered() const noexcept {
+		return static_cast<bool>(filter_);
 	}
 
 	size_t select(size_t front, size_t back, bool all) noexcept {
 		if (back < front) std::swap(front, back);
 		for (size_t i = front; i <= back; ++i) {
-			auto& it = its_.at(i);
-			if (it->data() != 0) continue;
+			const auto row = order_.at(i);
+			if (snap_.data(row) != 0) continue;
 			if (all) {
-				it->set_sel(true);
+				sel_[row] = 1;
 			} else {
-				it->set_sel(!it->is_sel());
-				sel_size_ += (it->is_sel() ? 1 : -1);
+				sel_[row] = !sel_[row];
+				sel_size_ += (sel_[row] ? 1 : -1);
 			}
 		}
 		if (all) sel_size_ = back - front + 1;
@@ -86,9 +281,7 @@ public:
 	}
 
 	void unselect() noexcept {
-		for (auto& it : its_) {
-			it->set_sel(false);
-		}
+		std::fill(sel_.begin(), sel_.end(), uint8_t{ 0 });
 		sel_size_ = 0;
 	}
 
@@ -0,0 +1,162 @@
+/**
+ * Link Resolver (Background Resolution of Targets of Shortcuts)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <unordered_map>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+
+#include "os.hpp"
+#include "shortcut.hpp"
+
+class LinkResolver {
+
+	inline static const size_t MAX_ENTRIES = 4096;
+
+public:
+
+	// Row, path and last write time (0 when not known) of a link
+	struct Request {
+		uint32_t row;
+		std::wstring path;
+		uint64_t time;
+	};
+
+	using Targets = std::vector<std::pair<uint32_t, std::wstring>>;  // Rows and their targets (empty when not resolved)
+
+private:
+
+	struct Entry {
+		uint64_t time;
+		std::wstring target;
+	};
+
+	// Shared with the worker, which is left to end by itself after the link being resolved when it is canceled
+	struct State {
+		std::mutex mutex;
+		std::vector<Request> reqs;  // Taken from the back
+		Targets pending;
+		uint64_t gen{};  // Incremented when the requests are canceled, so that the results of them are discarded
+		bool posted{};
+		bool running{};  // Whether a worker is taking the requests
+		std::unordered_map<std::wstring, Entry> cache;
+		std::function<void()> notify;
+	};
+
+	std::shared_ptr<State> st_{ std::make_shared<State>() };
+
+	// Resolve the links requested one by one until no request is left
+	static void run(std::shared_ptr<State> st) {
+		os::fail_critical_errors_in_thread();
+#ifdef _WIN32
+		const auto res = ::CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);  // For shell links
+#endif
+		while (true) {
+			Request r;
+			uint64_t gen;
+			{
+				std::lock_guard lock(st->mutex);
+				if (st->reqs.empty()) {
+					st->running = false;
+					break;
+				}
+				r = std::move(st->reqs.back());
+				st->reqs.pop_back();
+				gen = st->gen;
+			}
+			std::wstring target;
+			if (r.time == 0) os::file_time(r.path, r.time);
+			if (!find(*st, r.path, r.time, target)) target = shortcut::resolve(r.path);
+
+			std::function<void()> notify;
+			{
+				std::lock_guard lock(st->mutex);
+				if (st->cache.size() >= MAX_ENTRIES) st->cache.clear();
+				st->cache.insert_or_assign(r.path, Entry{ r.time, target });
+				if (gen != st->gen) continue;
+				st->pending.emplace_back(r.row, std::move(target));
+				if (!st->posted && st->reqs.empty()) {
+					st->posted = true;
+					notify = st->notify;
+				}
+			}
+			if (notify) notify();
+		}
+#ifdef _WIN32
+		if (SUCCEEDED(res)) ::CoUninitialize();
+#endif
+	}
+
+	static bool find(State& st, const std::wstring& path, uint64_t time, std::wstring& target) {
+		std::lock_guard lock(st.mutex);
+		const auto it = st.cache.find(path);
+		if (it == st.cache.end() || it->second.time != time) return false;
+		target = it->second.target;
+		return true;
+	}
+
+public:
+
+	LinkResolver() = default;
+	LinkResolver(const LinkResolver&) = delete;
+	LinkResolver& operator=(const LinkResolver&) = delete;
+	LinkResolver(LinkResolver&&) = delete;
+	LinkResolver& operator=(LinkResolver&&) = delete;
+
+	~LinkResolver() {
+		cancel();
+		std::lock_guard lock(st_->mutex);
+		st_->notify = nullptr;
+	}
+
+	// Set the function called from the worker when resolved targets are ready to be taken
+	void set_notifier(std::function<void()> fn) {
+		std::lock_guard lock(st_->mutex);
+		st_->notify = std::move(fn);
+	}
+
+	// Get the target of the link resolved before when the link has not been changed since then
+	bool cached(const std::wstring& path, uint64_t time, std::wstring& target) {
+		return time != 0 && find(*st_, path, time, target);
+	}
+
+	// Resolve the links in the background in order, replacing the requests not processed yet
+	void request(std::vector<Request> reqs) {
+		{
+			std::lock_guard lock(st_->mutex);
+			st_->reqs.assign(std::make_move_iterator(reqs.rbegin()), std::make_move_iterator(reqs.rend()));
+			if (st_->reqs.empty() || st_->running) return;
+			st_->running = true;
+		}
+		std::thread(run, st_).detach();
+	}
+
+	// Discard the requests and the targets not taken
+	void cancel() {
+		std::lock_guard lock(st_->mutex);
+		st_->reqs.clear();
+		st_->pending.clear();
+		++st_->gen;
+	}
+
+	// Take the targets resolved so far
+	void take(Targets& out) {
+		out.clear();
+		std::lock_guard lock(st_->mutex);
+		std::swap(out, st_->pending);
+		st_->posted = false;
+	}
+
+};
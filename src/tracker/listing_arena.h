@@ -0,0 +1,70 @@
+/**
+ * Listing Arena (Recycling and Trimming Memory of Item Lists)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <array>
+#include <utility>
+#include <cstddef>
+
+#include "item_list.h"
+
+class ListingArena {
+
+	inline static const size_t HISTORY_SIZE = 8;     // Number of recent listings remembered
+	inline static const size_t MIN_ITEMS    = 1024;  // Capacity that is always kept
+	inline static const size_t MIN_CHARS    = MIN_ITEMS * 32;
+	inline static const size_t SLACK        = 2;     // Trim only when capacity exceeds the mark this many times
+
+	std::array<size_t, HISTORY_SIZE> items_{};
+	std::array<size_t, HISTORY_SIZE> chars_{};
+	size_t next_{};
+	size_t trim_count_{};
+
+	// High-water mark of the recent listings
+	std::pair<size_t, size_t> high_water_mark() const noexcept {
+		size_t is = MIN_ITEMS, cs = MIN_CHARS;
+		for (size_t i = 0; i < HISTORY_SIZE; ++i) {
+			if (is < items_.at(i)) is = items_.at(i);
+			if (cs < chars_.at(i)) cs = chars_.at(i);
+		}
+		return { is, cs };
+	}
+
+public:
+
+	ListingArena() noexcept = default;
+	ListingArena(const ListingArena&) = delete;
+	ListingArena& operator=(const ListingArena&) = delete;
+	ListingArena(ListingArena&&) = delete;
+	ListingArena& operator=(ListingArena&&) = delete;
+	~ListingArena() = default;
+
+	// Empty the list for the next listing while keeping its memory up to the high-water mark
+	void recycle(ItemList& il) {
+		const auto [is, cs] = high_water_mark();
+		if (il.capacity() > is * SLACK || il.snapshot().text_capacity() > cs * SLACK) {
+			il.trim(is, cs);
+			++trim_count_;
+		} else {
+			il.clear();
+		}
+	}
+
+	// Remember the size of a completed listing
+	void record(const ItemList& il) noexcept {
+		items_.at(next_) = il.size();
+		chars_.at(next_) = il.snapshot().text_size();
+		next_ = (next_ + 1) % HISTORY_SIZE;
+	}
+
+	// Number of times a list was trimmed
+	size_t trim_count() const noexcept {
+		return trim_count_;
+	}
+
+};
@@ -0,0 +1,142 @@
+/**
+ * Listing Cache (LRU Cache of Directory Snapshots)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <list>
+#include <optional>
+#include <algorithm>
+
+#include "directory_snapshot.h"
+#include "directory_watcher.h"
+
+class ListingCache {
+
+	inline static const size_t MAX_ENTRIES = 16;
+	inline static const size_t MAX_ROWS    = 256 * 1024;  // Total rows kept in the cache
+
+	struct Entry {
+		std::wstring path;
+		int flags;
+		DirectorySnapshot snap;
+	};
+
+	std::list<Entry> es_;  // Most recently used first
+	DirectoryWatcher watcher_;
+	size_t rows_{};
+	DirectorySnapshot spare_;  // The largest of the snapshots dropped, whose memory is reused
+
+	// Keep the memory of a snapshot dropped when it is larger than that kept
+	void drop(DirectorySnapshot&& snap) {
+		if (snap.footprint() > spare_.footprint()) spare_ = std::move(snap);
+	}
+
+	void erase(const std::wstring& path) {
+		const auto it = std::find_if(es_.begin(), es_.end(), [&](const Entry& e) { return e.path == path; });
+		if (it == es_.end()) return;
+		rows_ -= it->snap.size();
+		drop(std::move(it->snap));
+		es_.erase(it);
+	}
+
+	// Drop the entries whose folders were changed
+	void invalidate() {
+		for (const auto& p : watcher_.changed()) erase(p);
+	}
+
+	void evict() {
+		while (!es_.empty() && (es_.size() > MAX_ENTRIES || rows_ > MAX_ROWS)) {
+			auto& e = es_.back();
+			rows_ -= e.snap.size();
+			drop(std::move(e.snap));
+			watcher_.remove(e.path);
+			es_.pop_back();
+		}
+	}
+
+public:
+
+	ListingCache() noexcept = default;
+	ListingCache(const ListingCache&) = delete;
+	ListingCache& operator=(const ListingCache&) = delete;
+	ListingCache(ListingCache&&) = delete;
+	ListingCache& operator=(ListingCache&&) = delete;
+	~ListingCache() = default;
+
+	// Start watching a folder before it is listed, so that the listing can be cached afterward
+	void watch(const std::wstring& path) {
+		watcher_.add(path);
+	}
+
+	// Keep the listing of a folder (discarded when the folder was changed while it was shown)
+	void put(const std::wstring& path, int flags, DirectorySnapshot&& snap) {
+		invalidate();
+		erase(path);
+		if (!watcher_.is_watching(path)) {
+			drop(std::move(snap));
+			return;
+		}
+		rows_ += snap.size();
+		es_.push_front({ path, flags, std::move(snap) });
+		evict();
+	}
+
+	// Take out the listing of a folder if it is cached, up to date and made with the same flags
+	std::optional<DirectorySnapshot> take(const std::wstring& path, int flags) {
+		invalidate();
+		const auto it = std::find_if(es_.begin(), es_.end(), [&](const Entry& e) { return e.path == path; });
+		if (it == es_.end()) return std::nullopt;
+		if (it->flags != flags) {
+			erase(path);
+			return std::nullopt;
+		}
+		rows_ -= it->snap.size();
+		std::optional<DirectorySnapshot> ret{ std::move(it->snap) };
+		es_.erase(it);  // The folder stays watched while it is shown
+		return ret;
+	}
+
+	// Forget a folder whose listing is not going to be kept
+	void remove(const std::wstring& path) {
+		erase(path);
+		watcher_.remove(path);
+	}
+
+	// Take out the memory of the snapshots dropped, emptied to be filled by another listing
+	DirectorySnapshot take_spare() {
+		DirectorySnapshot ret{ std::move(spare_) };
+		spare_ = DirectorySnapshot{};
+		ret.clear();
+		return ret;
+	}
+
+	void clear() {
+		es_.clear();
+		watcher_.clear();
+		rows_  = 0;
+		spare_ = DirectorySnapshot{};
+	}
+
+#ifdef _WIN32
+	// Set the window to which WM_DEVICECHANGE is sent when the device of a watched folder is about to be removed
+	void set_window(HWND wnd) noexcept {
+		watcher_.set_window(wnd);
+	}
+
+	// Forget the folder of the handle whose device is about to be removed
+	void release(HANDLE dir) {
+		watcher_.release(dir);
+		invalidate();
+	}
+#endif
+
+	size_t size() const noexcept {
+		return es_.size();
+	}
+
+};
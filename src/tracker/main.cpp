@@ -2,7 +2,7 @@
  * Main Function
  *
  * @author Takuto Yanagida
- * @version 2026-05-13
+ * @version 2026-10-17
  */
 
 #include <memory>
@@ -85,7 +85,8 @@ LRESULT CALLBACK wnd_proc(HWND wnd, UINT msg, WPARAM wp, LPARAM lp) {
 	case WM_SIZE:              view->wm_size(LOWORD(lp), HIWORD(lp)); break;
 	case WM_PAINT:             view->wm_paint(); break;
 	case WM_ACTIVATEAPP:       if (!wp && ::GetCapture() != wnd) ::ShowWindow(wnd, SW_HIDE); break;
-	case WM_TIMER:             view->wm_timer(); break;
+	case WM_TIMER:             view->wm_timer(wp); break;
+	case WM_DEVICECHANGE:      view->wm_device_change(wp, lp); break;
 	case WM_HOTKEY:            view->wm_hot_key(wp); break;
 	case WM_SHOWWINDOW:        view->wm_show_window(wp == TRUE); break;
 	case WM_LBUTTONDOWN:       view->wm_button_down(VK_LBUTTON, LOWORD(lp), HIWORD(lp)); break;
@@ -100,6 +101,7 @@ LRESULT CALLBACK wnd_proc(HWND wnd, UINT msg, WPARAM wp, LPARAM lp) {
 	case WM_ENDSESSION:        view->wm_end_session(); break;
 	case WM_REQUESTUPDATE:     view->wm_request_update(); break;
 	case WM_RENAMEEDITCLOSED:  view->wm_rename_edit_closed(); break;
+	case WM_LISTINGUPDATE:     view->wm_listing_update(); break;
 	case WM_KEYDOWN:           view->wm_key_down(wp); break;
 	case WM_ENTERMENULOOP:     view->wm_menu_loop(true); break;
 	case WM_EXITMENULOOP:      view->wm_menu_loop(false); break;
@@ -0,0 +1,100 @@
+/**
+ * Mapped File (Read-Only Memory Mapping of a File)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+#include "os.hpp"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+class MappedFile {
+
+#ifdef _WIN32
+	HANDLE file_{ INVALID_HANDLE_VALUE };
+	HANDLE map_{ nullptr };
+#else
+	int fd_{ -1 };
+#endif
+	const void* data_{ nullptr };
+	size_t size_{};
+
+public:
+
+	MappedFile() noexcept = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&&) = delete;
+	MappedFile& operator=(MappedFile&&) = delete;
+
+	~MappedFile() {
+		close();
+	}
+
+	// Map the whole file; the pages are shared with other processes mapping the same file
+	bool open(const std::wstring& path) {
+		close();
+#ifdef _WIN32
+		file_ = ::CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE) return false;
+		LARGE_INTEGER s{};
+		if (!::GetFileSizeEx(file_, &s) || s.QuadPart == 0) {
+			close();
+			return false;
+		}
+		map_ = ::CreateFileMapping(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (map_ != nullptr) data_ = ::MapViewOfFile(map_, FILE_MAP_READ, 0, 0, 0);
+		size_ = static_cast<size_t>(s.QuadPart);
+#else
+		fd_ = ::open(os::to_utf8(path).c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd_ == -1) return false;
+		struct stat st{};
+		if (::fstat(fd_, &st) != 0 || st.st_size == 0) {
+			close();
+			return false;
+		}
+		void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd_, 0);
+		if (p != MAP_FAILED) data_ = p;
+		size_ = static_cast<size_t>(st.st_size);
+#endif
+		if (data_ == nullptr) {
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void close() noexcept {
+#ifdef _WIN32
+		if (data_) ::UnmapViewOfFile(data_);
+		if (map_) ::CloseHandle(map_);
+		if (file_ != INVALID_HANDLE_VALUE) ::CloseHandle(file_);
+		map_  = nullptr;
+		file_ = INVALID_HANDLE_VALUE;
+#else
+		if (data_) ::munmap(const_cast<void*>(data_), size_);
+		if (fd_ != -1) ::close(fd_);
+		fd_ = -1;
+#endif
+		data_ = nullptr;
+		size_ = 0;
+	}
+
+	const void* data() const noexcept {
+		return data_;
+	}
+
+	size_t size() const noexcept {
+		return size_;
+	}
+
+};
@@ -0,0 +1,693 @@
+/**
+ * Matcher (Search Pattern Compiled Once and Reused)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <regex>
+#include <algorithm>
+#include <cstdint>
+#include <cwctype>
+
+class Matcher {
+
+	// Folding of characters for ignoring case, with a shortcut for ASCII
+	static wchar_t fold(wchar_t c) noexcept {
+		if (c < 0x80) return (L'A' <= c && c <= L'Z') ? static_cast<wchar_t>(c | 0x20) : c;
+		return static_cast<wchar_t>(std::towlower(c));
+	}
+
+	// Set of characters of a bracket expression or an escape like \d
+	struct CharClass {
+		std::vector<std::pair<wchar_t, wchar_t>> ranges;
+		bool neg = false;
+
+		bool contains(wchar_t c) const noexcept {
+			const auto in = [&](wchar_t d) {
+				for (const auto& [lo, hi] : ranges) {
+					if (lo <= d && d <= hi) return true;
+				}
+				return false;
+			};
+			const bool hit = in(c) || in(static_cast<wchar_t>(std::towupper(c)));  // c is folded
+			return hit != neg;
+		}
+	};
+
+	// Node of an NFA built by Thompson's construction
+	struct Node {
+		enum Op : uint8_t { CHAR, CLASS, ANY, SPLIT, MATCH };
+		Op       op;
+		wchar_t  c   = 0;
+		uint32_t cls = 0;
+		int      out = -1, out1 = -1;
+	};
+
+	// Parser of the regular expressions made by Migemo (alternations, groups, bracket expressions and quantifiers);
+	// returns false for the others so that std::wregex is used instead
+	class Parser {
+
+		struct Frag {
+			int start{};
+			std::vector<std::pair<int, bool>> outs;  // Nodes and which of out/out1 to be patched
+		};
+
+		inline static const int    MAX_DEPTH  = 256;
+		inline static const int    MAX_REPEAT = 256;
+		inline static const size_t MAX_NODES  = 1 << 16;  // Bounds the work for a character
+
+		std::wstring_view p_;
+		size_t i_ = 0;
+		int depth_ = 0;
+		bool looped_ = false;
+		std::vector<Node>& ns_;
+		std::vector<CharClass>& cs_;
+
+		int node(Node::Op op, wchar_t c = 0, uint32_t cls = 0) {
+			ns_.push_back({ op, c, cls });
+			return static_cast<int>(ns_.size() - 1);
+		}
+
+		void patch(const std::vector<std::pair<int, bool>>& outs, int to) noexcept {
+			for (const auto& [n, second] : outs) (second ? ns_[n].out1 : ns_[n].out) = to;
+		}
+
+		Frag single(Node::Op op, wchar_t c = 0, uint32_t cls = 0) {
+			const int n = node(op, c, cls);
+			return { n, { { n, false } } };
+		}
+
+		Frag empty() {
+			const int n = node(Node::SPLIT);
+			return { n, { { n, false } } };
+		}
+
+		static void add_class_escape(CharClass& cc, wchar_t e) {
+			switch (e) {
+			case L'd': cc.ranges.emplace_back(L'0', L'9'); break;
+			case L's':
+				cc.ranges.emplace_back(L'\t', L'\r');
+				cc.ranges.emplace_back(L' ', L' ');
+				cc.ranges.emplace_back(0x3000, 0x3000);
+				break;
+			case L'w':
+				cc.ranges.emplace_back(L'0', L'9');
+				cc.ranges.emplace_back(L'A', L'Z');
+				cc.ranges.emplace_back(L'_', L'_');
+				cc.ranges.emplace_back(L'a', L'z');
+				break;
+			}
+		}
+
+		// Character of an escape sequence (returns false for the unsupported ones)
+		bool escaped_char(wchar_t& c) {
+			if (i_ >= p_.size()) return false;
+			const wchar_t e = p_[i_++];
+			switch (e) {
+			case L't': c = L'\t'; return true;
+			case L'n': c = L'\n'; return true;
+			case L'r': c = L'\r'; return true;
+			case L'f': c = L'\f'; return true;
+			case L'v': c = L'\v'; return true;
+			case L'0': c = 0; return true;
+			case L'x': case L'u': {
+				const size_t len = (e == L'x') ? 2 : 4;
+				if (i_ + len > p_.size()) return false;
+				unsigned v = 0;
+				for (size_t k = 0; k < len; ++k) {
+					const wchar_t h = p_[i_++];
+					if (!std::iswxdigit(h)) return false;
+					v = v * 16 + static_cast<unsigned>(std::iswdigit(h) ? h - L'0' : (std::towlower(h) - L'a' + 10));
+				}
+				c = static_cast<wchar_t>(v);
+				return true;
+			}
+			}
+			if (std::iswalnum(e)) return false;  // Back references, word boundaries and so on
+			c = e;
+			return true;
+		}
+
+		bool bracket(Frag& f) {
+			CharClass cc;
+			if (i_ < p_.size() && p_[i_] == L'^') {
+				cc.neg = true;
+				++i_;
+			}
+			for (bool first = true; ; first = false) {
+				if (i_ >= p_.size()) return false;
+				wchar_t c = p_[i_++];
+				if (c == L']' && !first) break;
+				if (c == L'\\') {
+					if (i_ < p_.size() && (p_[i_] == L'd' || p_[i_] == L's' || p_[i_] == L'w')) {
+						add_class_escape(cc, p_[i_++]);
+						continue;
+					}
+					if (!escaped_char(c)) return false;
+				}
+				wchar_t hi = c;
+				if (i_ + 1 < p_.size() && p_[i_] == L'-' && p_[i_ + 1] != L']') {
+					++i_;
+					hi = p_[i_++];
+					if (hi == L'\\' && !escaped_char(hi)) return false;
+					if (hi < c) return false;
+				}
+				cc.ranges.emplace_back(c, hi);
+			}
+			cs_.push_back(std::move(cc));
+			f = single(Node::CLASS, 0, static_cast<uint32_t>(cs_.size() - 1));
+			return true;
+		}
+
+		bool atom(Frag& f) {
+			const wchar_t c = p_[i_++];
+			switch (c) {
+			case L'(':
+				if (i_ + 1 < p_.size() && p_[i_] == L'?') {
+					if (p_[i_ + 1] != L':') return false;  // Lookaheads
+					i_ += 2;
+				}
+				if (++depth_ > MAX_DEPTH || !alternation(f)) return false;
+				--depth_;
+				if (i_ >= p_.size() || p_[i_] != L')') return false;
+				++i_;
+				return true;
+			case L'[':
+				return bracket(f);
+			case L'.':
+				f = single(Node::ANY);
+				return true;
+			case L'\\':
+				if (i_ < p_.size() && (p_[i_] == L'd' || p_[i_] == L's' || p_[i_] == L'w' || p_[i_] == L'D' || p_[i_] == L'S' || p_[i_] == L'W')) {
+					CharClass cc;
+					const wchar_t e = p_[i_++];
+					add_class_escape(cc, static_cast<wchar_t>(std::towlower(e)));
+					cc.neg = std::iswupper(e) != 0;
+					cs_.push_back(std::move(cc));
+					f = single(Node::CLASS, 0, static_cast<uint32_t>(cs_.size() - 1));
+					return true;
+				} else {
+					wchar_t e{};
+					if (!escaped_char(e)) return false;
+					f = single(Node::CHAR, fold(e));
+					return true;
+				}
+			case L'^': case L'$': case L'{': case L'}': case L')': case L'*': case L'+': case L'?':
+				return false;
+			}
+			f = single(Node::CHAR, fold(c));
+			return true;
+		}
+
+		bool number(int& n) {
+			const size_t b = i_;
+			for (n = 0; i_ < p_.size() && L'0' <= p_[i_] && p_[i_] <= L'9'; ++i_) {
+				n = n * 10 + (p_[i_] - L'0');
+				if (n > MAX_REPEAT) return false;
+			}
+			return i_ != b;
+		}
+
+		// Counted repetition like {2}, {2,} and {2,4} of the atom from 'from', made of its copies parsed again
+		bool counted(Frag& f, size_t from) {
+			++i_;
+			int min = 0, max = 0;
+			if (!number(min)) return false;
+			bool unbounded = false;
+			if (i_ < p_.size() && p_[i_] == L',') {
+				++i_;
+				if (i_ < p_.size() && p_[i_] == L'}') unbounded = true;
+				else if (!number(max) || max < min) return false;
+			} else {
+				max = min;
+			}
+			if (i_ >= p_.size() || p_[i_] != L'}') return false;
+			if (++i_ < p_.size() && p_[i_] == L'?') ++i_;
+			const size_t next = i_;
+
+			Frag r;
+			bool has = false;
+			const int copies = unbounded ? (std::max)(min, 1) : max;
+			for (int k = 0; k < copies; ++k) {
+				Frag g;
+				if (k == 0) {
+					g = std::move(f);
+				} else {
+					i_ = from;
+					if (!atom(g) || ns_.size() > MAX_NODES) return false;
+				}
+				if (unbounded && k == copies - 1) {  // The last copy repeats
+					const int s = node(Node::SPLIT);
+					ns_[s].out = g.start;
+					patch(g.outs, s);
+					g.outs = { { s, true } };
+					if (min == 0) g.start = s;
+					looped_ = true;
+				} else if (k >= min) {  // Optional copies
+					const int s = node(Node::SPLIT);
+					ns_[s].out = g.start;
+					g.outs.emplace_back(s, true);
+					g.start = s;
+				}
+				if (has) {
+					patch(r.outs, g.start);
+					r.outs = std::move(g.outs);
+				} else {
+					r = std::move(g);
+					has = true;
+				}
+			}
+			f = has ? std::move(r) : empty();
+			i_ = next;
+			return true;
+		}
+
+		bool repetition(Frag& f) {
+			const size_t from = i_;
+			if (!atom(f)) return false;
+			if (i_ < p_.size() && p_[i_] == L'{' && !counted(f, from)) return false;
+			while (i_ < p_.size() && (p_[i_] == L'*' || p_[i_] == L'+' || p_[i_] == L'?')) {
+				const wchar_t q = p_[i_++];
+				if (i_ < p_.size() && p_[i_] == L'?') ++i_;  // Laziness does not change whether it matches
+				const int s = node(Node::SPLIT);
+				ns_[s].out = f.start;
+				if (q == L'?') {
+					f.outs.emplace_back(s, true);
+					f.start = s;
+				} else {
+					patch(f.outs, s);
+					f.outs = { { s, true } };
+					if (q == L'*') f.start = s;
+					looped_ = true;
+				}
+			}
+			return ns_.size() <= MAX_NODES;
+		}
+
+		bool sequence(Frag& f) {
+			bool has = false;
+			while (i_ < p_.size() && p_[i_] != L'|' && p_[i_] != L')') {
+				Frag g;
+				if (!repetition(g)) return false;
+				if (has) {
+					patch(f.outs, g.start);
+					f.outs = std::move(g.outs);
+				} else {
+					f = std::move(g);
+					has = true;
+				}
+			}
+			if (!has) f = empty();
+			return true;
+		}
+
+		bool alternation(Frag& f) {
+			if (!sequence(f)) return false;
+			while (i_ < p_.size() && p_[i_] == L'|') {
+				++i_;
+				Frag g;
+				if (!sequence(g)) return false;
+				const int s = node(Node::SPLIT);
+				ns_[s].out  = f.start;
+				ns_[s].out1 = g.start;
+				f.start = s;
+				f.outs.insert(f.outs.end(), g.outs.begin(), g.outs.end());
+			}
+			return true;
+		}
+
+	public:
+
+		Parser(std::wstring_view p, std::vector<Node>& ns, std::vector<CharClass>& cs) noexcept : p_(p), ns_(ns), cs_(cs) {}
+
+		// Parse the whole pattern and return the start node (-1 when it is not supported)
+		int parse() {
+			Frag f;
+			if (!alternation(f) || i_ != p_.size()) return -1;
+			patch(f.outs, node(Node::MATCH));
+			return f.start;
+		}
+
+		// Whether the pattern has a loop, so that it may match infinitely many words
+		bool looped() const noexcept {
+			return looped_;
+		}
+
+	};
+
+	// State of the DFA made lazily from the NFA; transitions of ASCII are in a table
+	struct DState {
+		std::vector<int> set;
+		bool accept = false;
+		std::array<int, 128> ascii;
+		std::unordered_map<wchar_t, int> other;
+	};
+
+	// Node of the trie of the words of a pattern with the failure links of Aho-Corasick
+	struct WNode {
+		uint32_t first = 0, count = 0;  // Edges sorted by characters
+		uint32_t fail  = 0;
+		bool     out   = false;         // Whether a word ends here or at a node the failure links reach
+	};
+
+	inline static const size_t MAX_STATES       = 4096;
+	inline static const size_t MAX_WORD_NODES   = 1 << 18;
+	inline static const size_t MAX_CLASS        = 1 << 12;
+	inline static const size_t MAX_REGEX_LENGTH = 1024;  // std::wregex recurses by the length of patterns
+	inline static const int    UNKNOWN          = -1;
+
+	enum class Mode { LITERAL, WORDS, AUTOMATON, REGEX };
+
+	Mode         mode_ = Mode::LITERAL;
+	std::wstring needle_;
+	std::wregex  re_;
+
+	std::vector<Node>      ns_;
+	std::vector<CharClass> cs_;
+	int                    start_ = -1;
+
+	std::vector<WNode>                        wns_;
+	std::vector<std::pair<wchar_t, uint32_t>> wes_;
+	std::array<uint32_t, 128>                 wroot_{};  // Edges of ASCII from the root, where most characters of names go
+
+	mutable std::vector<DState>             ds_;
+	mutable std::map<std::vector<int>, int> ids_;
+	mutable int                             start_id_ = UNKNOWN;
+	mutable std::vector<uint32_t>           mark_;
+	mutable uint32_t                        gen_ = 0;
+	mutable std::vector<int>                stack_;
+	mutable std::wstring                    buf_;
+
+	void next_generation() const {
+		if (++gen_ == 0) {
+			std::fill(mark_.begin(), mark_.end(), 0);
+			gen_ = 1;
+		}
+	}
+
+	// Add the nodes reachable from n without reading a character
+	void closure(int n, std::vector<int>& set) const {
+		stack_.push_back(n);
+		while (!stack_.empty()) {
+			const int m = stack_.back();
+			stack_.pop_back();
+			if (m < 0 || mark_[m] == gen_) continue;
+			mark_[m] = gen_;
+			if (ns_[m].op == Node::SPLIT) {
+				stack_.push_back(ns_[m].out1);
+				stack_.push_back(ns_[m].out);
+			} else {
+				set.push_back(m);
+			}
+		}
+	}
+
+	int state(std::vector<int>&& set) const {
+		std::sort(set.begin(), set.end());
+		if (const auto it = ids_.find(set); it != ids_.end()) return it->second;
+		DState d;
+		d.ascii.fill(UNKNOWN);
+		d.accept = std::any_of(set.begin(), set.end(), [&](int n) { return ns_[n].op == Node::MATCH; });
+		d.set = set;
+		ds_.push_back(std::move(d));
+		const int id = static_cast<int>(ds_.size() - 1);
+		ids_.emplace(std::move(set), id);
+		return id;
+	}
+
+	int start_state() const {
+		if (start_id_ == UNKNOWN) {
+			std::vector<int> set;
+			next_generation();
+			closure(start_, set);
+			start_id_ = state(std::move(set));
+		}
+		return start_id_;
+	}
+
+	// Nodes after reading c from a state, with the start added for matching anywhere
+	std::vector<int> step(int s, wchar_t c) const {
+		std::vector<int> next;
+		next_generation();
+		for (const int n : ds_[s].set) {
+			const auto& nd = ns_[n];
+			const bool hit = (nd.op == Node::CHAR && nd.c == c) || (nd.op == Node::ANY && c != L'\n') ||
+				(nd.op == Node::CLASS && cs_[nd.cls].contains(c));
+			if (hit) closure(nd.out, next);
+		}
+		closure(start_, next);
+		return next;
+	}
+
+	// Drop the states made so far except the current one, instead of growing without limit
+	int flush(int cur) const {
+		auto set = ds_[cur].set;
+		ds_.clear();
+		ids_.clear();
+		start_id_ = UNKNOWN;
+		start_state();
+		return state(std::move(set));
+	}
+
+	int transition(int& cur, wchar_t c) const {
+		if (c < 128) {
+			if (ds_[cur].ascii[c] != UNKNOWN) return ds_[cur].ascii[c];
+		} else if (const auto it = ds_[cur].other.find(c); it != ds_[cur].other.end()) {
+			return it->second;
+		}
+		auto set = step(cur, c);
+		if (ds_.size() >= MAX_STATES) cur = flush(cur);
+		const int next = state(std::move(set));
+		if (c < 128) ds_[cur].ascii[c] = next;
+		else ds_[cur].other.emplace(c, next);
+		return next;
+	}
+
+	bool run(std::wstring_view s) const {
+		int cur = start_state();
+		if (ds_[cur].accept) return true;
+		for (const wchar_t c : s) {
+			cur = transition(cur, fold(c));
+			if (ds_[cur].accept) return true;
+		}
+		return false;
+	}
+
+	// Make the trie of the words when the pattern matches a finite set of them, walking the NFA with the trie
+	bool build_words() {
+		std::vector<std::map<wchar_t, uint32_t>> tr(1);
+		std::vector<bool> out(1, false);
+		const auto child = [&](uint32_t t, wchar_t c) {
+			const auto [it, added] = tr[t].try_emplace(c, static_cast<uint32_t>(tr.size()));
+			const uint32_t v = it->second;
+			if (added) {
+				tr.emplace_back();
+				out.push_back(false);
+			}
+			return v;
+		};
+		std::unordered_set<uint64_t> seen;
+		std::vector<std::pair<int, uint32_t>> st{ { start_, 0 } };
+		while (!st.empty()) {
+			const auto [n, t] = st.back();
+			st.pop_back();
+			if (n < 0 || out[t] || !seen.insert((static_cast<uint64_t>(n) << 32) | t).second) continue;
+			const auto& nd = ns_[n];
+			switch (nd.op) {
+			case Node::CHAR:
+				st.emplace_back(nd.out, child(t, nd.c));
+				break;
+			case Node::CLASS: {
+				const auto& cc = cs_[nd.cls];
+				if (cc.neg) return false;
+				size_t size = 0;
+				for (const auto& [lo, hi] : cc.ranges) size += static_cast<size_t>(hi - lo) + 1;
+				if (size > MAX_CLASS) return false;
+				for (const auto& [lo, hi] : cc.ranges) {
+					for (wchar_t c = lo; ; ++c) {
+						if (const wchar_t f = fold(c); cc.contains(f)) st.emplace_back(nd.out, child(t, f));
+						if (c == hi) break;
+					}
+				}
+				break;
+			}
+			case Node::ANY:
+				return false;
+			case Node::SPLIT:
+				st.emplace_back(nd.out1, t);
+				st.emplace_back(nd.out, t);
+				break;
+			case Node::MATCH:
+				out[t] = true;  // Longer words are not needed since names match when a word is found
+				break;
+			}
+			if (tr.size() > MAX_WORD_NODES) return false;
+		}
+
+		// Failure links made breadth first, and the edges laid out by nodes
+		wns_.assign(tr.size(), WNode{});
+		std::vector<uint32_t> queue{ 0 };
+		for (size_t qi = 0; qi < queue.size(); ++qi) {
+			const uint32_t t = queue[qi];
+			auto& w = wns_[t];
+			w.out   = w.out || out[t];
+			w.first = static_cast<uint32_t>(wes_.size());
+			w.count = static_cast<uint32_t>(tr[t].size());
+			for (const auto& [c, v] : tr[t]) {
+				wes_.emplace_back(c, v);
+				uint32_t f = 0;
+				if (t != 0) {
+					for (f = w.fail; ; f = wns_[f].fail) {
+						if (const auto it = tr[f].find(c); it != tr[f].end()) {
+							f = it->second;
+							break;
+						}
+						if (f == 0) break;
+					}
+				}
+				wns_[v].fail = f;
+				wns_[v].out  = out[f] || wns_[f].out;
+				queue.push_back(v);
+			}
+		}
+		wroot_.fill(0);
+		for (const auto& [c, v] : tr[0]) {
+			if (c < 128) wroot_[c] = v;
+		}
+		return true;
+	}
+
+	uint32_t word_child(uint32_t t, wchar_t c) const noexcept {
+		if (t == 0 && c < 128) return wroot_[c];
+		const auto b = wes_.begin() + wns_[t].first;
+		const auto e = b + wns_[t].count;
+		const auto it = std::lower_bound(b, e, c, [](const auto& p, wchar_t d) { return p.first < d; });
+		return (it != e && it->first == c) ? it->second : 0;
+	}
+
+	bool run_words(std::wstring_view s) const {
+		uint32_t t = 0;
+		if (wns_[0].out) return true;
+		for (const wchar_t c : s) {
+			const wchar_t f = fold(c);
+			for (;;) {
+				if (const uint32_t n = word_child(t, f)) {
+					t = n;
+					break;
+				}
+				if (t == 0) break;
+				t = wns_[t].fail;
+			}
+			if (wns_[t].out) return true;
+		}
+		return false;
+	}
+
+	void reset_automaton() {
+		wns_.clear();
+		wes_.clear();
+		ns_.clear();
+		cs_.clear();
+		ds_.clear();
+		ids_.clear();
+		start_id_ = UNKNOWN;
+		start_    = -1;
+	}
+
+public:
+
+	Matcher() noexcept = default;
+	Matcher(const Matcher&) = delete;
+	Matcher& operator=(const Matcher&) = delete;
+	Matcher(Matcher&&) = delete;
+	Matcher& operator=(Matcher&&) = delete;
+	~Matcher() = default;
+
+	// Match names containing the word, ignoring case
+	void set_literal(std::wstring_view word) {
+		reset_automaton();
+		mode_ = Mode::LITERAL;
+		needle_.clear();
+		for (const wchar_t c : word) needle_.push_back(fold(c));
+	}
+
+	// Match names by a regular expression ignoring case (returns false when it is invalid or too long to run safely)
+	// Patterns of a finite set of words like those of Migemo are run by Aho-Corasick, and the others by a DFA
+	// made lazily, both in linear time to names; only the syntax not supported by them is left to std::wregex
+	bool set_pattern(std::wstring_view pattern) {
+		reset_automaton();
+		Parser parser{ pattern, ns_, cs_ };
+		start_ = parser.parse();
+		if (start_ != -1) {
+			if (!parser.looped() && build_words()) {
+				mode_ = Mode::WORDS;
+				ns_.clear();
+				cs_.clear();
+				return true;
+			}
+			wns_.clear();
+			wes_.clear();
+			mode_ = Mode::AUTOMATON;
+			mark_.assign(ns_.size(), 0);
+			gen_ = 0;
+			return true;
+		}
+		reset_automaton();
+		if (pattern.size() > MAX_REGEX_LENGTH) {
+			set_literal(L"");
+			return false;
+		}
+		try {
+			re_.assign(pattern.begin(), pattern.end(), std::regex_constants::ECMAScript | std::regex_constants::icase | std::regex_constants::optimize);
+		} catch (const std::regex_error&) {
+			set_literal(L"");
+			return false;
+		}
+		mode_ = Mode::REGEX;
+		return true;
+	}
+
+	bool match(std::wstring_view s) const {
+		switch (mode_) {
+		case Mode::LITERAL:
+			if (needle_.empty()) return true;
+			if (s.size() < needle_.size()) return false;
+			buf_.resize(s.size());
+			for (size_t i = 0; i < s.size(); ++i) buf_[i] = fold(s[i]);
+			return std::wstring_view{ buf_ }.find(needle_) != std::wstring_view::npos;
+		case Mode::WORDS:
+			return run_words(s);
+		case Mode::AUTOMATON:
+			return run(s);
+		case Mode::REGEX:
+			return std::regex_search(s.begin(), s.end(), re_);
+		}
+		return false;
+	}
+
+	// Whether the pattern is run by an automaton instead of std::wregex
+	bool is_automaton() const noexcept {
+		return mode_ == Mode::WORDS || mode_ == Mode::AUTOMATON;
+	}
+
+	// Whether the pattern is run by Aho-Corasick as a set of words
+	bool is_words() const noexcept {
+		return mode_ == Mode::WORDS;
+	}
+
+	// Word folded that names must contain, only when a literal is set
+	std::wstring_view literal() const noexcept {
+		return (mode_ == Mode::LITERAL) ? std::wstring_view{ needle_ } : std::wstring_view{};
+	}
+
+};
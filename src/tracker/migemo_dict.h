@@ -0,0 +1,263 @@
+/**
+ * Migemo Dictionary (Trie of Readings Mapped from a Precompiled Image)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <tuple>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+
+#include "os.hpp"
+#include "text_reader_writer.hpp"
+#include "mapped_file.h"
+
+class MigemoDict {
+
+public:
+
+	// Node of the trie in breadth-first order, so that the children of a node and the words of the nodes are
+	// contiguous; their ends are where those of the next node start (children are sorted by their labels)
+	struct Node {
+		uint32_t first;  // Children
+		uint32_t words;  // Words read as the path to the node, separated by tabs
+	};
+
+private:
+
+	// The image is a header, the nodes followed by a sentinel, the labels of the nodes and the pool of words
+	// in UTF-16, each aligned to 4 bytes
+	struct Header {
+		char     magic[8];
+		uint32_t version;
+		uint32_t node_count;
+		uint64_t source_size;  // Size and time of the text dictionary compiled into the image
+		uint64_t source_time;
+		uint32_t pool_size;
+		uint32_t reserved;
+	};
+
+	inline static const char     MAGIC[8] = { 'T', 'R', 'K', 'M', 'I', 'G', 'E', 'M' };
+	inline static const uint32_t VERSION  = 2;
+
+	MappedFile            map_;
+	std::vector<uint32_t> buf_;  // Image made in memory when it cannot be mapped
+	const Node*           ns_     = nullptr;
+	const char16_t*       labels_ = nullptr;
+	const char16_t*       pool_   = nullptr;
+	size_t                size_{};
+
+	static size_t align(size_t n) noexcept {
+		return (n + 3) & ~size_t{ 3 };
+	}
+
+	static size_t image_size(uint32_t node_count, uint32_t pool_size) noexcept {
+		return sizeof(Header) + sizeof(Node) * (static_cast<size_t>(node_count) + 1) + align(sizeof(char16_t) * node_count) + sizeof(char16_t) * pool_size;
+	}
+
+	// Use the image after checking that the children and the words of each node are in its ranges, so that
+	// a broken image is not followed out of it nor round in cycles
+	bool attach(const void* data, size_t size, uint64_t src_size, uint64_t src_time, bool check_source) noexcept {
+		if (size < sizeof(Header)) return false;
+		const auto* h = static_cast<const Header*>(data);
+		if (std::memcmp(&h->magic[0], &MAGIC[0], sizeof(MAGIC)) != 0 || h->version != VERSION) return false;
+		if (check_source && (h->source_size != src_size || h->source_time != src_time)) return false;
+		if (h->node_count == 0 || h->node_count > UINT32_MAX - 1 || size < image_size(h->node_count, h->pool_size)) return false;
+
+		const auto* p  = static_cast<const char*>(data) + sizeof(Header);
+		const auto* ns = reinterpret_cast<const Node*>(p);
+		const uint32_t n = h->node_count;
+		if (ns[0].words != 0 || ns[n].first != n || ns[n].words != h->pool_size) return false;
+		for (uint32_t i = 0; i < n; ++i) {
+			if (ns[i].first <= i || ns[i].first > ns[i + 1].first || ns[i].words > ns[i + 1].words) return false;
+		}
+		ns_     = ns;
+		labels_ = reinterpret_cast<const char16_t*>(p + sizeof(Node) * (static_cast<size_t>(n) + 1));
+		pool_   = reinterpret_cast<const char16_t*>(p + sizeof(Node) * (static_cast<size_t>(n) + 1) + align(sizeof(char16_t) * n));
+		size_   = n;
+		return true;
+	}
+
+	const Node* child(const Node& n, wchar_t c) const noexcept {
+		if (static_cast<uint32_t>(c) > 0xFFFF) return nullptr;
+		const char16_t* b = labels_ + n.first;
+		const char16_t* e = labels_ + (&n + 1)->first;
+		const char16_t* it = std::lower_bound(b, e, static_cast<char16_t>(c));
+		return (it != e && *it == static_cast<char16_t>(c)) ? ns_ + (it - labels_) : nullptr;
+	}
+
+public:
+
+	MigemoDict() noexcept = default;
+	MigemoDict(const MigemoDict&) = delete;
+	MigemoDict& operator=(const MigemoDict&) = delete;
+	MigemoDict(MigemoDict&&) = delete;
+	MigemoDict& operator=(MigemoDict&&) = delete;
+	~MigemoDict() = default;
+
+	// Path of the image compiled from a text dictionary
+	static std::wstring image_path(const std::wstring& path) {
+		return path + L".img";
+	}
+
+	// Compile a text dictionary of lines of a reading and words separated by tabs into an image
+	// (lines starting with ';' are comments, and the readings out of the BMP are ignored)
+	static bool compile(const std::wstring& path, std::vector<uint32_t>& out) {
+		uint64_t src_size{}, src_time{};
+		if (!os::file_size(path, src_size) || !os::file_time(path, src_time)) return false;
+		const std::wstring text = text_reader_writer::read_cp932(path);
+
+		std::vector<std::pair<std::wstring_view, std::wstring_view>> es;  // Reading and words
+		for (size_t pos = 0; pos < text.size();) {
+			size_t eol = text.find(L'\n', pos);
+			if (eol == std::wstring::npos) eol = text.size();
+			size_t end = eol;
+			if (end > pos && text[end - 1] == L'\r') --end;
+			const size_t tab = text.find(L'\t', pos);
+			if (text[pos] != L';' && tab < end && pos < tab) {
+				const std::wstring_view r{ text.data() + pos, tab - pos };
+				if (std::all_of(r.begin(), r.end(), [](wchar_t c) { return static_cast<uint32_t>(c) <= 0xFFFF; })) {
+					es.emplace_back(r, std::wstring_view{ text.data() + tab + 1, end - tab - 1 });
+				}
+			}
+			pos = eol + 1;
+		}
+		if (es.empty()) return false;
+		std::stable_sort(es.begin(), es.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+		// Nodes are made breadth first so that the children of each node are contiguous
+		std::vector<Node> ns{ Node{} };
+		std::u16string labels{ u'\0' };
+		std::u16string pool;
+		std::deque<std::tuple<uint32_t, size_t, size_t, size_t>> queue{ { 0, 0, es.size(), 0 } };  // Node, range of entries and depth
+		while (!queue.empty()) {
+			const auto [n, lo, hi, depth] = queue.front();
+			queue.pop_front();
+			size_t i = lo;
+			ns[n].words = static_cast<uint32_t>(pool.size());
+			for (; i < hi && es[i].first.size() == depth; ++i) {
+				if (pool.size() > ns[n].words) pool.push_back(u'\t');
+				os::append_utf16(pool, es[i].second);
+			}
+			ns[n].first = static_cast<uint32_t>(ns.size());
+			while (i < hi) {
+				const wchar_t c = es[i].first[depth];
+				size_t e = i + 1;
+				while (e < hi && es[e].first[depth] == c) ++e;
+				queue.emplace_back(static_cast<uint32_t>(ns.size()), i, e, depth + 1);
+				ns.push_back({ 0, 0 });
+				labels.push_back(static_cast<char16_t>(c));
+				i = e;
+			}
+		}
+		const auto n = static_cast<uint32_t>(ns.size());
+		ns.push_back({ n, static_cast<uint32_t>(pool.size()) });  // Sentinel
+
+		Header h{};
+		std::memcpy(&h.magic[0], &MAGIC[0], sizeof(MAGIC));
+		h.version     = VERSION;
+		h.node_count  = n;
+		h.source_size = src_size;
+		h.source_time = src_time;
+		h.pool_size   = static_cast<uint32_t>(pool.size());
+
+		const size_t size = image_size(h.node_count, h.pool_size);
+		out.assign((size + sizeof(uint32_t) - 1) / sizeof(uint32_t), 0);
+		auto* p = reinterpret_cast<char*>(out.data());
+		std::memcpy(p, &h, sizeof(h));
+		p += sizeof(h);
+		std::memcpy(p, ns.data(), sizeof(Node) * ns.size());
+		p += sizeof(Node) * ns.size();
+		std::memcpy(p, labels.data(), sizeof(char16_t) * labels.size());
+		p += align(sizeof(char16_t) * labels.size());
+		std::memcpy(p, pool.data(), sizeof(char16_t) * pool.size());
+		return true;
+	}
+
+	// Write the image to a temporary file and replace the file by it, since the file may be mapped
+	static bool save(const std::wstring& path, const std::vector<uint32_t>& image) {
+		const auto temp = path + L".tmp";
+		{
+			std::ofstream ofs(os::native_path(temp), std::ios::binary);
+			if (!ofs) return false;
+			ofs.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size() * sizeof(uint32_t)));
+			if (!ofs) return false;
+		}
+		return os::replace_file(temp, path);
+	}
+
+	// Map the image of the text dictionary made beforehand next to it, or the one in the cache; when neither
+	// is up to date, the text is compiled, and the image is written to the cache for the next time if the
+	// cache is given (nothing is written next to the text)
+	bool load(const std::wstring& path, const std::wstring& cache = {}) {
+		map_.close();
+		buf_.clear();
+		ns_ = nullptr;
+		uint64_t src_size{}, src_time{};
+		const bool has_src = os::file_size(path, src_size) && os::file_time(path, src_time);
+
+		for (const auto& img : { image_path(path), cache }) {
+			if (img.empty()) continue;
+			if (map_.open(img) && attach(map_.data(), map_.size(), src_size, src_time, has_src)) return true;
+			map_.close();
+		}
+		if (!has_src || !compile(path, buf_)) return false;
+		if (!cache.empty()) save(cache, buf_);
+		return attach(buf_.data(), buf_.size() * sizeof(uint32_t), src_size, src_time, true);
+	}
+
+	// Whether the image is mapped rather than compiled at loading
+	bool is_mapped() const noexcept {
+		return ns_ != nullptr && buf_.empty();
+	}
+
+	// Number of nodes of the trie
+	size_t size() const noexcept {
+		return size_;
+	}
+
+	// Node reached from the root by the prefix (nullptr when no reading starts with it)
+	const Node* find(std::wstring_view prefix, const Node* from = nullptr) const noexcept {
+		if (!ns_) return nullptr;
+		const Node* n = from ? from : ns_;
+		for (const wchar_t c : prefix) {
+			n = child(*n, c);
+			if (!n) return nullptr;
+		}
+		return n;
+	}
+
+	// Call fn with each word read as the path to the node or its descendants
+	template<typename F> void each_word(const Node* node, F fn) const {
+		std::vector<const Node*> stack{ node };
+		std::wstring word;
+		while (!stack.empty()) {
+			const Node* n = stack.back();
+			stack.pop_back();
+			std::u16string_view ws{ pool_ + n->words, (n + 1)->words - n->words };
+			while (!ws.empty()) {
+				const size_t t = ws.find(u'\t');
+				os::assign_utf16(word, ws.substr(0, t));
+				if (!word.empty()) fn(std::wstring_view{ word });
+				if (t == std::u16string_view::npos) break;
+				ws.remove_prefix(t + 1);
+			}
+			for (uint32_t i = n->first; i < (n + 1)->first; ++i) stack.push_back(ns_ + i);
+		}
+	}
+
+	// Call fn with each word whose reading starts with prefix
+	template<typename F> void prefix_query(std::wstring_view prefix, F fn) const {
+		if (const Node* n = find(prefix)) each_word(n, fn);
+	}
+
+};
@@ -0,0 +1,185 @@
+/**
+ * Migemo Engine (Romaji Search of Japanese Names)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cwctype>
+
+#include "path.hpp"
+#include "file_system.hpp"
+#include "conversion_table.h"
+#include "migemo_dict.h"
+#include "regex_generator.h"
+
+class MigemoEngine {
+
+	ConversionTable roma2hira_;
+	ConversionTable hira2kata_;
+	ConversionTable han2zen_;
+	ConversionTable zen2han_;
+	MigemoDict      dict_;
+	RegexGenerator  rx_;
+	bool            loaded_ = false;
+
+	static bool is_vowel(wchar_t c) noexcept {
+		return c == L'a' || c == L'i' || c == L'u' || c == L'e' || c == L'o';
+	}
+
+	static std::wstring to_lower(std::wstring_view s) {
+		std::wstring ret{ s };
+		for (auto& c : ret) c = static_cast<wchar_t>(std::towlower(c));
+		return ret;
+	}
+
+	// Expansion state of a word of the query, extended key by key
+	struct Word {
+		std::wstring word;  // As typed
+		std::wstring hira;  // Hiragana of the romaji converted so far
+		std::wstring tail;  // Romaji left for the keys to come
+		const MigemoDict::Node* lower = nullptr;  // Cursors of the dictionary by the word in small letters and by hira
+		const MigemoDict::Node* kana  = nullptr;
+	};
+
+	std::wstring              last_;   // Query expanded last
+	std::vector<std::wstring> done_;   // Patterns of the words finished in the query
+	Word                      cur_;
+
+	void start_word() {
+		cur_ = Word{};
+		cur_.lower = dict_.find(L"");
+		cur_.kana  = cur_.lower;
+	}
+
+	void append_hira(std::wstring_view h) {
+		cur_.hira.append(h);
+		if (cur_.kana) cur_.kana = dict_.find(h, cur_.kana);
+	}
+
+	// Convert the romaji of the tail as far as more keys cannot change it
+	void convert_tail() {
+		const auto* xn  = roma2hira_.find(L"xn");
+		const auto* xtu = roma2hira_.find(L"xtu");
+		auto& t = cur_.tail;
+		while (!t.empty() && !roma2hira_.has_longer(t)) {
+			const std::wstring* to = nullptr;
+			if (const size_t len = roma2hira_.longest_match(t, to)) {
+				append_hira(*to);
+				t.erase(0, len);
+				continue;
+			}
+			const wchar_t c = t[0];
+			const bool consonant = L'a' <= c && c <= L'z' && !is_vowel(c);
+			if (t.size() > 1 && xtu && consonant && c != L'n' && t[1] == c) {  // Doubled consonant
+				append_hira(*xtu);
+			} else if (t.size() > 1 && xn && c == L'n' && !is_vowel(t[1]) && t[1] != L'y') {
+				append_hira(*xn);
+			} else {
+				append_hira(std::wstring_view{ &c, 1 });
+			}
+			t.erase(0, 1);
+		}
+	}
+
+	// Extend the expansion state by a key; a capital letter after a small one starts a new word ("kanjiNyuuryoku")
+	void feed(wchar_t c) {
+		if (std::iswspace(c) || (std::iswupper(c) && !cur_.word.empty() && std::iswlower(cur_.word.back()))) {
+			if (!cur_.word.empty()) done_.push_back(generate());
+			start_word();
+			if (std::iswspace(c)) return;
+		}
+		const auto lc = static_cast<wchar_t>(std::towlower(c));
+		cur_.word.push_back(c);
+		if (cur_.lower) cur_.lower = dict_.find(std::wstring_view{ &lc, 1 }, cur_.lower);
+		cur_.tail.push_back(lc);
+		convert_tail();
+	}
+
+	void add_with_dict(std::wstring_view w, const MigemoDict::Node* n) {
+		rx_.add(w);
+		if (n) dict_.each_word(n, [&](std::wstring_view word) { rx_.add(word); });
+	}
+
+	void add_kana(const std::wstring& hira, const MigemoDict::Node* n) {
+		add_with_dict(hira, n);
+		const auto kata = hira2kata_.convert(hira);
+		rx_.add(kata);
+		rx_.add(zen2han_.convert(kata));
+	}
+
+	// Pattern of the current word; when its romaji ends halfway like "kak", all the kana starting so are candidates
+	std::wstring generate() {
+		const std::wstring lower = to_lower(cur_.word);
+		rx_.clear();
+		rx_.add(cur_.word);
+		add_with_dict(lower, cur_.lower);
+		rx_.add(han2zen_.convert(cur_.word));
+		rx_.add(han2zen_.convert(lower));
+		rx_.add(zen2han_.convert(cur_.word));
+
+		if (cur_.tail.empty()) {
+			add_kana(cur_.hira, cur_.kana);
+		} else {
+			roma2hira_.each_with_prefix(cur_.tail, [&](const std::wstring&, const std::wstring& to) {
+				add_kana(cur_.hira + to, cur_.kana ? dict_.find(to, cur_.kana) : nullptr);
+			});
+		}
+		return rx_.generate();
+	}
+
+public:
+
+	MigemoEngine() noexcept = default;
+	MigemoEngine(const MigemoEngine&) = delete;
+	MigemoEngine& operator=(const MigemoEngine&) = delete;
+	MigemoEngine(MigemoEngine&&) = delete;
+	MigemoEngine& operator=(MigemoEngine&&) = delete;
+	~MigemoEngine() = default;
+
+	// Read the dictionaries in the folder ('dict' next to the module when it is empty); the image of the
+	// Migemo dictionary is kept in the cache file when it is not made beforehand
+	bool load(const std::wstring& dict_dir = std::wstring(), const std::wstring& cache = std::wstring()) {
+		const std::wstring sep(1, path::PATH_SEPARATOR);
+		std::wstring dir(dict_dir);
+		if (dir.empty()) dir = path::parent(file_system::module_file_path()).append(sep + L"dict");
+		dir.append(sep);
+
+		last_.clear();
+		loaded_ = dict_.load(dir + L"migemo-dict", cache) && roma2hira_.load(dir + L"roma2hira.dat");
+		if (loaded_) {
+			hira2kata_.load(dir + L"hira2kata.dat");
+			han2zen_.load(dir + L"han2zen.dat");
+			zen2han_.load(dir + L"zen2han.dat");
+		}
+		return loaded_;
+	}
+
+	bool is_loaded() const noexcept {
+		return loaded_;
+	}
+
+	// Make a regular expression matching the romaji query and the Japanese words read so
+	// When the query extends the last one, only the keys appended are converted and looked up
+	void query(const std::wstring& word, std::wstring& pattern) {
+		size_t from = 0;
+		if (!last_.empty() && word.starts_with(last_)) {
+			from = last_.size();
+		} else {
+			done_.clear();
+			start_word();
+		}
+		for (size_t i = from; i < word.size(); ++i) feed(word[i]);
+		last_ = word;
+
+		pattern.clear();
+		for (const auto& p : done_) pattern.append(p);
+		if (!cur_.word.empty()) pattern.append(generate());
+	}
+
+};
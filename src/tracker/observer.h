@@ -2,7 +2,7 @@
  * Observer
  *
  * @author Takuto Yanagida
- * @version 2025-11-10
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -13,6 +13,8 @@ public:
 
 	virtual void updated() = 0;
 
+	virtual void appended() = 0;
+
 	Observer() noexcept = default;
 	Observer(const Observer&) = delete;
 	virtual Observer& operator=(const Observer&) = delete;
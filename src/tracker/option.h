@@ -2,13 +2,14 @@
  * Document Options
  *
  * @author Takuto Yanagida
- * @version 2026-05-13
+ * @version 2026-10-17
  */
 
 #pragma once
 
 #include <vector>
 
+#include "tracker.h"
 #include "pref.hpp"
 #include "item_list.h"
 
@@ -49,7 +50,7 @@ public:
 		return sort_by_;
 	}
 
-	TCHAR get_sort_type_char() const noexcept {
+	wchar_t get_sort_type_char() const noexcept {
 		switch (sort_by_) {
 		case sbName: return sort_rev_ ? 'N' : 'n';
 		case sbType: return sort_rev_ ? 'T' : 't';
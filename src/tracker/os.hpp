@@ -0,0 +1,691 @@
+/**
+ * OS Abstraction Layer
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cwchar>
+#include <cwctype>
+#include <cstdlib>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <shlwapi.h>
+#include <shlobj.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <time.h>
+#include <climits>
+#include <filesystem>
+#include <iconv.h>
+#include <cerrno>
+#include <cstdio>
+#endif
+
+namespace os {
+
+#ifdef _WIN32
+	constexpr wchar_t PATH_SEPARATOR  = L'\\';
+	constexpr size_t  MAX_PATH_LENGTH = MAX_PATH;
+	using native_string = std::wstring;
+#else
+	constexpr wchar_t PATH_SEPARATOR  = L'/';
+	constexpr size_t  MAX_PATH_LENGTH = PATH_MAX;
+	using native_string = std::string;
+#endif
+
+	// Same bits as FILE_ATTRIBUTE_*
+	constexpr uint32_t ATTR_HIDDEN        = 0x02;
+	constexpr uint32_t ATTR_DIRECTORY     = 0x10;
+	constexpr uint32_t ATTR_REPARSE_POINT = 0x400;  // Symbolic links and junctions
+	constexpr uint32_t ATTR_INVALID       = 0xFFFFFFFF;
+
+	// Offset between 1601-01-01 and 1970-01-01 in 100-ns ticks
+	constexpr uint64_t EPOCH_DIFF_TICKS = 116444736000000000ULL;
+
+	// Directory entry (time is in FILETIME ticks)
+	struct FindData {
+		std::wstring_view name;
+		uint32_t          attr;
+		uint64_t          size;
+		uint64_t          time;
+	};
+
+	// ------------------------------------------------------------------------
+
+	// Encode a wide string to UTF-8
+	inline std::string to_utf8(std::wstring_view s) {
+		std::string ret;
+		ret.reserve(s.size());
+		for (size_t i = 0; i < s.size(); ++i) {
+			uint32_t c = static_cast<uint32_t>(s[i]);
+			if constexpr (sizeof(wchar_t) == 2) {
+				if (0xD800 <= c && c < 0xDC00 && i + 1 < s.size()) {
+					const uint32_t l = static_cast<uint32_t>(s[i + 1]);
+					if (0xDC00 <= l && l < 0xE000) {
+						c = 0x10000 + ((c - 0xD800) << 10) + (l - 0xDC00);
+						++i;
+					}
+				}
+			}
+			if (c < 0x80) {
+				ret.push_back(static_cast<char>(c));
+			} else if (c < 0x800) {
+				ret.push_back(static_cast<char>(0xC0 | (c >> 6)));
+				ret.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+			} else if (c < 0x10000) {
+				ret.push_back(static_cast<char>(0xE0 | (c >> 12)));
+				ret.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+				ret.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+			} else {
+				ret.push_back(static_cast<char>(0xF0 | (c >> 18)));
+				ret.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+				ret.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+				ret.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+			}
+		}
+		return ret;
+	}
+
+	// Append a code point to a wide string
+	inline void append_code_point(std::wstring& out, uint32_t c) {
+		if constexpr (sizeof(wchar_t) == 2) {
+			if (c >= 0x10000) {
+				c -= 0x10000;
+				out.push_back(static_cast<wchar_t>(0xD800 + (c >> 10)));
+				out.push_back(static_cast<wchar_t>(0xDC00 + (c & 0x3FF)));
+				return;
+			}
+		}
+		out.push_back(static_cast<wchar_t>(c));
+	}
+
+	// Decode UTF-8 to a wide string (invalid bytes become U+FFFD)
+	inline std::wstring from_utf8(std::string_view s) {
+		std::wstring ret;
+		ret.reserve(s.size());
+		for (size_t i = 0; i < s.size();) {
+			const auto b = static_cast<unsigned char>(s[i]);
+			size_t   len = 0;
+			uint32_t c   = 0;
+			if (b < 0x80)                { len = 1; c = b; }
+			else if ((b & 0xE0) == 0xC0) { len = 2; c = b & 0x1F; }
+			else if ((b & 0xF0) == 0xE0) { len = 3; c = b & 0x0F; }
+			else if ((b & 0xF8) == 0xF0) { len = 4; c = b & 0x07; }
+			bool ok = len != 0 && i + len <= s.size();
+			for (size_t j = 1; ok && j < len; ++j) {
+				const auto t = static_cast<unsigned char>(s[i + j]);
+				if ((t & 0xC0) != 0x80) ok = false;
+				c = (c << 6) | (t & 0x3F);
+			}
+			if (!ok) {
+				ret.push_back(L'\xFFFD');
+				++i;
+				continue;
+			}
+			append_code_point(ret, c);
+			i += len;
+		}
+		return ret;
+	}
+
+	// Decode UTF-16LE bytes to a wide string
+	inline std::wstring from_utf16le(std::string_view bytes) {
+		std::wstring ret;
+		const size_t n = bytes.size() / 2;
+		ret.reserve(n);
+		for (size_t i = 0; i < n; ++i) {
+			const auto lo = static_cast<unsigned char>(bytes[i * 2]);
+			const auto hi = static_cast<unsigned char>(bytes[i * 2 + 1]);
+			uint32_t c = lo | (hi << 8);
+			if constexpr (sizeof(wchar_t) != 2) {
+				if (0xD800 <= c && c < 0xDC00 && i + 1 < n) {
+					const uint32_t l = static_cast<unsigned char>(bytes[i * 2 + 2]) | (static_cast<unsigned char>(bytes[i * 2 + 3]) << 8);
+					if (0xDC00 <= l && l < 0xE000) {
+						c = 0x10000 + ((c - 0xD800) << 10) + (l - 0xDC00);
+						++i;
+					}
+				}
+			}
+			ret.push_back(static_cast<wchar_t>(c));
+		}
+		return ret;
+	}
+
+	// Encode a wide string to UTF-16LE bytes
+	inline void append_utf16le(std::string& out, std::wstring_view s) {
+		auto put = [&](uint32_t u) {
+			out.push_back(static_cast<char>(u & 0xFF));
+			out.push_back(static_cast<char>((u >> 8) & 0xFF));
+		};
+		for (const wchar_t wc : s) {
+			const auto c = static_cast<uint32_t>(wc);
+			if (c >= 0x10000) {
+				put(0xD800 + ((c - 0x10000) >> 10));
+				put(0xDC00 + ((c - 0x10000) & 0x3FF));
+			} else {
+				put(c);
+			}
+		}
+	}
+
+	// Encode a wide string to UTF-16 units
+	inline void append_utf16(std::u16string& out, std::wstring_view s) {
+		for (const wchar_t wc : s) {
+			const auto c = static_cast<uint32_t>(wc);
+			if (c >= 0x10000) {
+				out.push_back(static_cast<char16_t>(0xD800 + ((c - 0x10000) >> 10)));
+				out.push_back(static_cast<char16_t>(0xDC00 + ((c - 0x10000) & 0x3FF)));
+			} else {
+				out.push_back(static_cast<char16_t>(c));
+			}
+		}
+	}
+
+	// Decode UTF-16 units to a wide string
+	inline void assign_utf16(std::wstring& out, std::u16string_view s) {
+		out.clear();
+		for (size_t i = 0; i < s.size(); ++i) {
+			uint32_t c = s[i];
+			if (0xD800 <= c && c < 0xDC00 && i + 1 < s.size() && 0xDC00 <= s[i + 1] && s[i + 1] < 0xE000) {
+				c = 0x10000 + ((c - 0xD800) << 10) + (s[i + 1] - 0xDC00u);
+				++i;
+			}
+			append_code_point(out, c);
+		}
+	}
+
+	// Convert a path to the form accepted by the file APIs and streams
+	inline native_string native_path(const std::wstring& path) {
+#ifdef _WIN32
+		return path;
+#else
+		return to_utf8(path);
+#endif
+	}
+
+	// ------------------------------------------------------------------------
+
+	// Milliseconds from an arbitrary origin
+	inline uint64_t tick_count() noexcept {
+#ifdef _WIN32
+		return ::GetTickCount64();
+#else
+		timespec ts{};
+		::clock_gettime(CLOCK_MONOTONIC, &ts);
+		return static_cast<uint64_t>(ts.tv_sec) * 1000 + static_cast<uint64_t>(ts.tv_nsec) / 1000000;
+#endif
+	}
+
+	// Get file attributes (ATTR_INVALID when the file does not exist)
+	inline uint32_t file_attributes(const std::wstring& path) noexcept {
+#ifdef _WIN32
+		if (0 == path.compare(0, 4, L"\\\\?\\")) return ::GetFileAttributes(path.c_str());
+		return ::GetFileAttributes((L"\\\\?\\" + path).c_str());
+#else
+		struct stat st{};
+		if (::stat(to_utf8(path).c_str(), &st) != 0) return ATTR_INVALID;
+		return S_ISDIR(st.st_mode) ? ATTR_DIRECTORY : 0;
+#endif
+	}
+
+	// Get the size of a file
+	inline bool file_size(const std::wstring& path, uint64_t& size) noexcept {
+#ifdef _WIN32
+		auto hf = ::CreateFile(path.c_str(), 0, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+		if (hf == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+		LARGE_INTEGER s{};
+		::GetFileSizeEx(hf, &s);
+		size = s.QuadPart;
+		::CloseHandle(hf);
+		return true;
+#else
+		struct stat st{};
+		if (::stat(to_utf8(path).c_str(), &st) != 0) return false;
+		size = static_cast<uint64_t>(st.st_size);
+		return true;
+#endif
+	}
+
+	// Get the last write time of a file in FILETIME ticks
+	inline bool file_time(const std::wstring& path, uint64_t& time) noexcept {
+#ifdef _WIN32
+		WIN32_FILE_ATTRIBUTE_DATA fad{};
+		if (!::GetFileAttributesEx(path.c_str(), GetFileExInfoStandard, &fad)) return false;
+		time = (static_cast<uint64_t>(fad.ftLastWriteTime.dwHighDateTime) << 32) | fad.ftLastWriteTime.dwLowDateTime;
+		return true;
+#else
+		struct stat st{};
+		if (::stat(to_utf8(path).c_str(), &st) != 0) return false;
+		time = static_cast<uint64_t>(st.st_mtim.tv_sec) * 10000000ULL + static_cast<uint64_t>(st.st_mtim.tv_nsec) / 100 + EPOCH_DIFF_TICKS;
+		return true;
+#endif
+	}
+
+	// Enumerate the entries of dir (dir must end with a separator)
+	template<typename F> bool find_files(const std::wstring& dir, F fn) {
+#ifdef _WIN32
+		const auto pattern = dir + L"*";
+		WIN32_FIND_DATA wfd{};
+		auto sh = ::FindFirstFileEx(pattern.c_str(), FindExInfoBasic, &wfd, FindExSearchNameMatch, nullptr, 0);
+		if (sh == INVALID_HANDLE_VALUE) return false;
+		do {
+			const FindData fd{
+				std::wstring_view{ &wfd.cFileName[0] },
+				wfd.dwFileAttributes,
+				(static_cast<uint64_t>(wfd.nFileSizeHigh) << 32) | wfd.nFileSizeLow,
+				(static_cast<uint64_t>(wfd.ftLastWriteTime.dwHighDateTime) << 32) | wfd.ftLastWriteTime.dwLowDateTime
+			};
+			if (!fn(fd)) break;
+		} while (::FindNextFile(sh, &wfd));
+		::FindClose(sh);
+		return true;
+#else
+		DIR* d = ::opendir(to_utf8(dir).c_str());
+		if (d == nullptr) return false;
+		const int fd_dir = ::dirfd(d);
+		std::wstring name;
+		while (const dirent* e = ::readdir(d)) {
+			struct stat st{};
+			uint32_t attr = 0;
+			if (::fstatat(fd_dir, &e->d_name[0], &st, 0) != 0 && ::fstatat(fd_dir, &e->d_name[0], &st, AT_SYMLINK_NOFOLLOW) != 0) {
+				continue;
+			}
+			if (S_ISDIR(st.st_mode)) attr |= ATTR_DIRECTORY;
+			if (e->d_type == DT_LNK) attr |= ATTR_REPARSE_POINT;
+			name = from_utf8(&e->d_name[0]);
+			const FindData fd{
+				name,
+				attr,
+				S_ISDIR(st.st_mode) ? 0 : static_cast<uint64_t>(st.st_size),
+				static_cast<uint64_t>(st.st_mtim.tv_sec) * 10000000ULL + static_cast<uint64_t>(st.st_mtim.tv_nsec) / 100 + EPOCH_DIFF_TICKS
+			};
+			if (!fn(fd)) break;
+		}
+		::closedir(d);
+		return true;
+#endif
+	}
+
+	// Check whether the path is a removable disk
+	inline bool is_removable(const std::wstring& path) noexcept {
+#ifdef _WIN32
+		return ::GetDriveType(path.c_str()) == DRIVE_REMOVABLE;
+#else
+		(void)path;
+		return false;
+#endif
+	}
+
+	// Prevent the system from showing critical error dialogs for the calling thread
+	inline void fail_critical_errors_in_thread() noexcept {
+#ifdef _WIN32
+		::SetThreadErrorMode(SEM_FAILCRITICALERRORS, nullptr);
+#endif
+	}
+
+	// Get drive size
+	inline void drive_size(const std::wstring& path, uint64_t& size, uint64_t& free) noexcept {
+#ifdef _WIN32
+		ULARGE_INTEGER f{}, s{};
+		::GetDiskFreeSpaceEx(path.c_str(), &f, &s, nullptr);
+		free = f.QuadPart;
+		size = s.QuadPart;
+#else
+		struct statvfs sv{};
+		if (::statvfs(to_utf8(path).c_str(), &sv) != 0) {
+			free = size = 0;
+			return;
+		}
+		free = static_cast<uint64_t>(sv.f_bavail) * sv.f_frsize;
+		size = static_cast<uint64_t>(sv.f_blocks) * sv.f_frsize;
+#endif
+	}
+
+	// Make a directory
+	inline bool create_directory(const std::wstring& path) noexcept {
+#ifdef _WIN32
+		return ::CreateDirectory(path.c_str(), nullptr) == TRUE;
+#else
+		return ::mkdir(to_utf8(path).c_str(), 0777) == 0;
+#endif
+	}
+
+	// Copy a file
+	inline bool copy_file(const std::wstring& from, const std::wstring& to, bool fail_if_exists) noexcept {
+#ifdef _WIN32
+		return ::CopyFile(from.c_str(), to.c_str(), fail_if_exists ? TRUE : FALSE) == TRUE;
+#else
+		std::error_code ec;
+		const auto opt = fail_if_exists ? std::filesystem::copy_options::none : std::filesystem::copy_options::overwrite_existing;
+		return std::filesystem::copy_file(to_utf8(from), to_utf8(to), opt, ec);
+#endif
+	}
+
+	// Replace a file by another file, which is renamed to it
+	inline bool replace_file(const std::wstring& from, const std::wstring& to) noexcept {
+#ifdef _WIN32
+		return ::MoveFileEx(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) == TRUE;
+#else
+		return std::rename(to_utf8(from).c_str(), to_utf8(to).c_str()) == 0;
+#endif
+	}
+
+	// Get the exe file path
+	inline std::wstring module_file_path() {
+#ifdef _WIN32
+		std::vector<wchar_t> buf(MAX_PATH);
+		for (DWORD nSize = MAX_PATH;; nSize *= 2) {
+			buf.resize(nSize);
+			const auto len = ::GetModuleFileName(nullptr, buf.data(), nSize);
+			if (::GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+				return std::wstring(buf.data(), len);
+			}
+		}
+#else
+		std::error_code ec;
+		const auto p = std::filesystem::read_symlink("/proc/self/exe", ec);
+		return ec ? std::wstring{} : from_utf8(p.native());
+#endif
+	}
+
+	// Get the current directory path
+	inline std::wstring current_directory_path() {
+#ifdef _WIN32
+		std::vector<wchar_t> buf(MAX_PATH);
+		for (DWORD nSize = MAX_PATH;;) {
+			buf.resize(nSize);
+			nSize = ::GetCurrentDirectory(nSize, buf.data());
+			if (nSize < buf.size()) {
+				return std::wstring(buf.data());
+			}
+		}
+#else
+		std::error_code ec;
+		const auto p = std::filesystem::current_path(ec);
+		return ec ? std::wstring{} : from_utf8(p.native());
+#endif
+	}
+
+	// Get desktop directory path
+	inline std::wstring desktop_path() {
+		std::wstring ret;
+#ifdef _WIN32
+		PWSTR buf = nullptr;
+		if (::SHGetKnownFolderPath(FOLDERID_Desktop, 0, nullptr, &buf) == S_OK) {
+			ret.assign(buf);
+			::CoTaskMemFree(buf);
+		}
+#else
+		if (const char* home = std::getenv("HOME")) {
+			ret.assign(from_utf8(home)).append(L"/Desktop");
+		}
+#endif
+		return ret;
+	}
+
+	// Get the name of the current user
+	inline std::wstring user_name() {
+#ifdef _WIN32
+		DWORD bufLen = MAX_PATH;
+		std::vector<wchar_t> buf(bufLen);
+
+		while (true) {
+			::GetUserName(buf.data(), &bufLen);
+			if (::GetLastError() != ERROR_INSUFFICIENT_BUFFER) break;
+			bufLen *= 2;
+			buf.resize(bufLen);
+		}
+		return std::wstring{ buf.data() };
+#else
+		if (const char* u = std::getenv("USER")) return from_utf8(u);
+		if (const char* u = std::getenv("LOGNAME")) return from_utf8(u);
+		return {};
+#endif
+	}
+
+	// ------------------------------------------------------------------------
+
+	// Compare strings
+	inline int compare_string(const wchar_t* s1, const wchar_t* s2) noexcept {
+#ifdef _WIN32
+		return ::lstrcmp(s1, s2);
+#else
+		return std::wcscmp(s1, s2);
+#endif
+	}
+
+	// Color of grayed text (COLORREF)
+	inline int gray_text_color() noexcept {
+#ifdef _WIN32
+		return ::GetSysColor(COLOR_GRAYTEXT);
+#else
+		return 0x6D6D6D;
+#endif
+	}
+
+	// ------------------------------------------------------------------------
+
+	// Convert a multibyte string of the thread code page into a wide string (returns required size including null)
+	inline int multi_byte_to_wide(const char* src, wchar_t* dest, int size) noexcept {
+#ifdef _WIN32
+		return ::MultiByteToWideChar(CP_THREAD_ACP, 0, src, -1, dest, size);
+#else
+		std::mbstate_t st{};
+		const char* p = src;
+		const auto len = std::mbsrtowcs(nullptr, &p, 0, &st);
+		if (len == static_cast<size_t>(-1)) return 0;
+		if (dest == nullptr) return static_cast<int>(len + 1);
+		p  = src;
+		st = {};
+		std::mbsrtowcs(dest, &p, static_cast<size_t>(size), &st);
+		if (size > 0) dest[size - 1] = L'\0';
+		return static_cast<int>(len + 1);
+#endif
+	}
+
+	// Decode Shift_JIS (code page 932) bytes to a wide string
+	inline std::wstring from_cp932(std::string_view bytes) {
+		std::wstring ret;
+		if (bytes.empty()) return ret;
+#ifdef _WIN32
+		const int len = ::MultiByteToWideChar(932, 0, bytes.data(), static_cast<int>(bytes.size()), nullptr, 0);
+		ret.resize(static_cast<size_t>(len));
+		::MultiByteToWideChar(932, 0, bytes.data(), static_cast<int>(bytes.size()), ret.data(), len);
+#else
+		const iconv_t cd = ::iconv_open("UTF-32LE", "CP932");
+		if (cd == reinterpret_cast<iconv_t>(-1)) return ret;
+		std::string out(bytes.size() * 4 + 4, '\0');
+		char*  in    = const_cast<char*>(bytes.data());
+		size_t in_n  = bytes.size();
+		char*  dst   = out.data();
+		size_t dst_n = out.size();
+		while (in_n > 0) {
+			if (::iconv(cd, &in, &in_n, &dst, &dst_n) != static_cast<size_t>(-1)) break;
+			if (errno != EILSEQ || dst_n < 4) break;
+			++in;  // Skip an invalid byte as U+FFFD
+			--in_n;
+			for (const char c : { '\xFD', '\xFF', '\0', '\0' }) *dst++ = c;
+			dst_n -= 4;
+		}
+		::iconv_close(cd);
+		const size_t n = (out.size() - dst_n) / 4;
+		ret.reserve(n);
+		for (size_t i = 0; i < n; ++i) {
+			const auto* b = reinterpret_cast<const unsigned char*>(out.data() + i * 4);
+			append_code_point(ret, b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24));
+		}
+#endif
+		return ret;
+	}
+
+	// ------------------------------------------------------------------------
+
+#ifndef _WIN32
+	namespace detail {
+
+		inline bool equals_ignore_case(std::wstring_view a, std::wstring_view b) noexcept {
+			if (a.size() != b.size()) return false;
+			for (size_t i = 0; i < a.size(); ++i) {
+				if (std::towlower(a[i]) != std::towlower(b[i])) return false;
+			}
+			return true;
+		}
+
+		inline std::wstring_view trim(std::wstring_view s) noexcept {
+			while (!s.empty() && std::iswspace(s.front())) s.remove_prefix(1);
+			while (!s.empty() && std::iswspace(s.back())) s.remove_suffix(1);
+			return s;
+		}
+
+		// Read an INI file as lines (UTF-16LE with BOM, or UTF-8)
+		inline std::vector<std::wstring> read_profile(const std::wstring& file) {
+			std::vector<std::wstring> lines;
+			std::ifstream ifs(native_path(file), std::ios::binary);
+			if (!ifs) return lines;
+			const std::string bytes{ std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>() };
+
+			std::wstring text;
+			if (bytes.size() >= 2 && static_cast<unsigned char>(bytes[0]) == 0xFF && static_cast<unsigned char>(bytes[1]) == 0xFE) {
+				text = from_utf16le(std::string_view(bytes).substr(2));
+			} else {
+				text = from_utf8(bytes);
+			}
+			size_t pos = 0;
+			while (pos < text.size()) {
+				auto nl = text.find(L'\n', pos);
+				if (nl == std::wstring::npos) nl = text.size();
+				auto line = text.substr(pos, nl - pos);
+				if (!line.empty() && line.back() == L'\r') line.pop_back();
+				lines.emplace_back(std::move(line));
+				pos = nl + 1;
+			}
+			return lines;
+		}
+
+		inline void write_profile(const std::wstring& file, const std::vector<std::wstring>& lines) {
+			std::string bytes{ "\xFF\xFE" };
+			for (const auto& line : lines) {
+				append_utf16le(bytes, line);
+				append_utf16le(bytes, L"\r\n");
+			}
+			std::ofstream ofs(native_path(file), std::ios::binary);
+			ofs.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+		}
+
+		inline bool is_section(std::wstring_view line, std::wstring_view sec) noexcept {
+			const auto t = trim(line);
+			return t.size() >= 2 && t.front() == L'[' && t.back() == L']' && equals_ignore_case(trim(t.substr(1, t.size() - 2)), sec);
+		}
+
+		inline bool is_key(std::wstring_view line, std::wstring_view key, std::wstring_view& val) noexcept {
+			const auto eq = line.find(L'=');
+			if (eq == std::wstring_view::npos || !equals_ignore_case(trim(line.substr(0, eq)), key)) return false;
+			val = trim(line.substr(eq + 1));
+			return true;
+		}
+
+	}
+#endif
+
+	// Read a string from an INI file
+	inline std::wstring profile_string(const std::wstring& file, const wchar_t* sec, const wchar_t* key, const wchar_t* def) {
+#ifdef _WIN32
+		std::vector<wchar_t> buf(MAX_PATH);
+		DWORD nSize{ MAX_PATH };
+
+		while (true) {
+			const auto outLen = ::GetPrivateProfileString(sec, key, def, buf.data(), nSize, file.c_str());
+			if (outLen != buf.size() - 1) break;
+			nSize *= 2;
+			buf.resize(nSize);
+		}
+		return { buf.data() };
+#else
+		bool in_sec = false;
+		for (const auto& line : detail::read_profile(file)) {
+			if (!line.empty() && detail::trim(line).starts_with(L'[')) {
+				in_sec = detail::is_section(line, sec);
+				continue;
+			}
+			std::wstring_view val;
+			if (in_sec && detail::is_key(line, key, val)) {
+				if (val.size() >= 2 && (val.front() == L'"' || val.front() == L'\'') && val.back() == val.front()) {
+					val = val.substr(1, val.size() - 2);
+				}
+				return std::wstring{ val };
+			}
+		}
+		return def;
+#endif
+	}
+
+	// Read an integer from an INI file
+	inline int profile_int(const std::wstring& file, const wchar_t* sec, const wchar_t* key, int def) {
+#ifdef _WIN32
+		return ::GetPrivateProfileInt(sec, key, def, file.c_str());
+#else
+		const auto s = profile_string(file, sec, key, L"");
+		if (s.empty()) return def;
+		return static_cast<int>(std::wcstol(s.c_str(), nullptr, 10));
+#endif
+	}
+
+	// Write a string to an INI file (whole section is removed when key is nullptr)
+	inline void set_profile_string(const std::wstring& file, const wchar_t* sec, const wchar_t* key, const wchar_t* val) {
+#ifdef _WIN32
+		::WritePrivateProfileString(sec, key, val, file.c_str());
+#else
+		auto lines = detail::read_profile(file);
+		size_t sec_bgn = lines.size(), sec_end = lines.size();
+		for (size_t i = 0; i < lines.size(); ++i) {
+			if (!detail::trim(lines[i]).starts_with(L'[')) continue;
+			if (sec_bgn != lines.size()) {
+				sec_end = i;
+				break;
+			}
+			if (detail::is_section(lines[i], sec)) sec_bgn = i;
+		}
+		if (key == nullptr) {
+			if (sec_bgn != lines.size()) lines.erase(lines.begin() + sec_bgn, lines.begin() + sec_end);
+		} else {
+			const std::wstring entry = std::wstring{ key } + L"=" + (val ? val : L"");
+			if (sec_bgn == lines.size()) {
+				if (val == nullptr) return;
+				lines.emplace_back(std::wstring{ L"[" } + sec + L"]");
+				lines.emplace_back(entry);
+			} else {
+				bool done = false;
+				for (size_t i = sec_bgn + 1; i < sec_end; ++i) {
+					std::wstring_view v;
+					if (!detail::is_key(lines[i], key, v)) continue;
+					if (val) lines[i] = entry;
+					else lines.erase(lines.begin() + i);
+					done = true;
+					break;
+				}
+				if (!done && val) {
+					size_t at = sec_end;
+					while (at > sec_bgn + 1 && detail::trim(lines[at - 1]).empty()) --at;
+					lines.insert(lines.begin() + at, entry);
+				}
+			}
+		}
+		detail::write_profile(file, lines);
+#endif
+	}
+
+};
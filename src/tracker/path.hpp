@@ -2,7 +2,7 @@
  * File Path Operations
  *
  * @author Takuto Yanagida
- * @version 2026-04-30
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -10,30 +10,33 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cwctype>
+
+#include "os.hpp"
 
 const std::wstring PATH_EXT_DIR(L"<folder>");
 
 namespace path {
 
-	constexpr wchar_t PATH_SEPARATOR   = L'\\';  // File path separator
+	constexpr wchar_t PATH_SEPARATOR   = os::PATH_SEPARATOR;  // File path separator
 	constexpr wchar_t DRIVE_IDENTIFIER = L':';   // Drive identifier
 	constexpr wchar_t EXT_PREFIX       = L'.';   // Extension prefix
 
 	constexpr wchar_t const * const UNC_PREFIX = L"\\\\?\\";
 	constexpr size_t UNC_PREFIX_SIZE = 4;
 
-	bool has_unc_prefix(const std::wstring& path) noexcept {
+	inline bool has_unc_prefix(const std::wstring& path) noexcept {
 		return 0 == path.compare(0, UNC_PREFIX_SIZE, UNC_PREFIX);
 	}
 
-	void append_root_separator_if_drive(std::wstring& out, const std::wstring& path) noexcept {
+	inline void append_root_separator_if_drive(std::wstring& out, const std::wstring& path) noexcept {
 		if (path.back() == DRIVE_IDENTIFIER) {
 			out.append(1, PATH_SEPARATOR);
 		}
 	}
 
 	// Extract file name (UNC ok)
-	std::wstring name(const std::wstring& path) noexcept {
+	inline std::wstring name(const std::wstring& path) noexcept {
 		const auto size = path.size();
 		const auto last = (path.back() == PATH_SEPARATOR) ? size - 2 : size - 1;
 		const auto pos  = path.find_last_of(PATH_SEPARATOR, last);
@@ -45,7 +48,7 @@ namespace path {
 	}
 
 	// Extract file name without extention
-	std::wstring name_without_ext(const std::wstring& path) noexcept {
+	inline std::wstring name_without_ext(const std::wstring& path) noexcept {
 		auto ret = name(path);
 		const auto pos = ret.find_last_of(EXT_PREFIX);
 		if (pos != std::wstring::npos) ret.resize(pos);
@@ -53,7 +56,7 @@ namespace path {
 	}
 
 	// Extract file extention
-	std::wstring ext(const std::wstring& path) noexcept {
+	inline std::wstring ext(const std::wstring& path) noexcept {
 		auto n = name(path);
 		const auto pos = n.find_last_of(EXT_PREFIX);
 
@@ -66,13 +69,16 @@ namespace path {
 	}
 
 	// Extract parent path
-	std::wstring parent(const std::wstring& path) noexcept {
+	inline std::wstring parent(const std::wstring& path) noexcept {
 		const auto size = path.size();
 		const auto pos = path.find_last_of(PATH_SEPARATOR);
 
 		if (pos == std::wstring::npos) {  // Abnormal
 			return L"";  // Return empty
 		}
+		if (pos == 0) {  // When root '/'
+			return (size == 1) ? L"" : path.substr(0, 1);
+		}
 		if (1 < size && path.at(pos - 1) == DRIVE_IDENTIFIER) {  // When root 'C:\'
 			if (pos == size - 1) {  // Pos is the tail end
 				return L"";  // Return empty
@@ -84,12 +90,12 @@ namespace path {
 	}
 
 	// Quote path
-	std::wstring quote(const std::wstring& path) noexcept {
+	inline std::wstring quote(const std::wstring& path) noexcept {
 		return (L'\"' + path).append(1, L'\"');
 	}
 
 	// Ensure the path begin with UNC prefix "\\?\"
-	std::wstring ensure_unc_prefix(const std::wstring& path) noexcept {
+	inline std::wstring ensure_unc_prefix(const std::wstring& path) noexcept {
 		if (has_unc_prefix(path)) {
 			return path;
 		}
@@ -97,7 +103,7 @@ namespace path {
 	}
 
 	// Ensure the path does not begin with UNC prefix "\\?\"
-	std::wstring ensure_no_unc_prefix(const std::wstring& path) noexcept {
+	inline std::wstring ensure_no_unc_prefix(const std::wstring& path) noexcept {
 		if (has_unc_prefix(path)) {
 			return path.substr(UNC_PREFIX_SIZE);
 		}
@@ -105,16 +111,16 @@ namespace path {
 	}
 
 	// Ensure the path begin with UNC prefix "\\?\" if the path is too long.
-	std::wstring ensure_unc_prefix_if_needed(const std::wstring& path) noexcept {
+	inline std::wstring ensure_unc_prefix_if_needed(const std::wstring& path) noexcept {
 		const auto p = ensure_no_unc_prefix(path);
-		if (MAX_PATH - 1 < p.size()) {
+		if (os::MAX_PATH_LENGTH - 1 < p.size()) {
 			return ensure_unc_prefix(p);
 		}
 		return p;
 	}
 
 	// Translate relative path to absolute path
-	std::wstring absolute_path(const std::wstring& path, const std::wstring& module_file_path) noexcept {
+	inline std::wstring absolute_path(const std::wstring& path, const std::wstring& module_file_path) noexcept {
 		if (path.at(0) == EXT_PREFIX && path.at(1) == PATH_SEPARATOR) {
 			auto ret = parent(module_file_path);
 			return ret.append(path, 1);
@@ -123,7 +129,7 @@ namespace path {
 	}
 
 	// Make quoted and space-separated path string
-	std::wstring space_separated_quoted_paths_string(const std::vector<std::wstring>& paths) noexcept {
+	inline std::wstring space_separated_quoted_paths_string(const std::vector<std::wstring>& paths) noexcept {
 		std::wstring ret;
 		for (const auto& path : paths) {
 			ret.append(1, L'\"').append(ensure_unc_prefix_if_needed(path));
@@ -135,7 +141,7 @@ namespace path {
 	}
 
 	// Make NULL-separated and double-NULL-terminated path string
-	std::wstring null_separated_paths_string(const std::vector<std::wstring>& paths) noexcept {
+	inline std::wstring null_separated_paths_string(const std::vector<std::wstring>& paths) noexcept {
 		std::wstring ret;
 		for (const auto& path : paths) {
 			ret.append(path);
@@ -147,9 +153,10 @@ namespace path {
 	}
 
 	// Check whether the path is root
-	bool is_root(const std::wstring& path) noexcept {
+	inline bool is_root(const std::wstring& path) noexcept {
 		const auto size = path.size();
 		return
+			(size == 1 && path.front() == PATH_SEPARATOR) ||
 			(1 < size && path.at(size - 2) == DRIVE_IDENTIFIER && path.at(size - 1) == PATH_SEPARATOR) ||
 			(0 < size && path.at(size - 1) == DRIVE_IDENTIFIER);
 	}
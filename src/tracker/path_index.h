@@ -0,0 +1,823 @@
+/**
+ * Path Index (Trigram Index of the Names below Root Folders)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <stop_token>
+#include <chrono>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <cwctype>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "os.hpp"
+#include "path.hpp"
+#include "file_system.hpp"
+#include "mapped_file.h"
+#include "change_journal.h"
+#include "directory_lister.h"
+#include "matcher.h"
+#include "text_reader_writer.hpp"
+
+class PathIndex {
+
+	inline static const uint32_t NONE        = 0xFFFFFFFF;
+	inline static const size_t   MAX_ENTRIES = 1 << 22;
+	inline static const uint32_t NAME_BLOCK  = 16;  // Names front-coded from the head of each block
+	inline static const char     MAGIC[8]    = { 'T', 'R', 'K', 'P', 'I', 'D', 'X', '2' };
+	inline static const uint32_t VERSION     = 1;
+
+	inline static const uint64_t POLL_INTERVAL       = 1000;       // Interval of taking the changes [ms]
+	inline static const uint64_t NOTIFY_INTERVAL     = 100;        // Minimum interval of notifications of the entries found [ms]
+	inline static const uint64_t MIN_UPDATE_INTERVAL = 30 * 1000;  // Minimum interval of updating the index by the changes [ms]
+
+	// Folder or file; the children of a folder are contiguous and sorted by their names
+	struct Entry {
+		uint32_t parent;        // NONE for the roots, whose names are their paths
+		uint32_t first, count;  // Children (count is NONE for the folders not listed)
+		uint32_t attr;
+		uint64_t size;
+		uint64_t time;          // Last write time, by which unchanged folders are not listed again
+	};
+
+	// The image is a header followed by the entries, the offsets of the name blocks, the trigrams with the
+	// offsets and the lengths of their postings, the names and the postings, each aligned to 8 bytes
+	// Names are front-coded and postings are delta-coded, both in varints as are the characters
+	struct Header {
+		char     magic[8];
+		uint32_t version;
+		uint32_t entry_count;
+		uint32_t root_count;
+		uint32_t key_count;
+		uint64_t names_size;
+		uint64_t posts_size;
+	};
+
+	static size_t align(size_t n) noexcept {
+		return (n + 7) & ~size_t{ 7 };
+	}
+
+	static void put_varint(std::string& out, uint32_t v) {
+		while (v >= 0x80) {
+			out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+			v >>= 7;
+		}
+		out.push_back(static_cast<char>(v));
+	}
+
+	// Read a varint, not beyond the end of the data
+	static uint32_t get_varint(const uint8_t*& p, const uint8_t* end) noexcept {
+		uint32_t v = 0;
+		for (int s = 0; p < end && s < 35; s += 7) {
+			const uint8_t b = *p++;
+			v |= static_cast<uint32_t>(b & 0x7F) << s;
+			if (!(b & 0x80)) break;
+		}
+		return v;
+	}
+
+	template<typename T> static void put(std::string& out, const T* data, size_t n) {
+		out.append(reinterpret_cast<const char*>(data), sizeof(T) * n);
+		out.resize(align(out.size()), '\0');
+	}
+
+	// Index mapped from the file, or kept in memory when it cannot be mapped; only read after being made
+	class Image {
+
+		MappedFile      map_;
+		std::string     buf_;
+		const Entry*    es_{};
+		const uint32_t* name_offs_{};
+		const uint64_t* keys_{};
+		const uint32_t* post_offs_{};
+		const uint32_t* post_lens_{};
+		const uint8_t*  names_{};
+		const uint8_t*  names_end_{};
+		const uint8_t*  posts_{};
+		const uint8_t*  posts_end_{};
+		uint32_t        size_{}, root_count_{}, key_count_{};
+
+		bool attach(const void* data, size_t size) noexcept {
+			if (size < sizeof(Header)) return false;
+			const auto* h = static_cast<const Header*>(data);
+			if (std::memcmp(&h->magic[0], &MAGIC[0], sizeof(MAGIC)) != 0 || h->version != VERSION) return false;
+			if (h->entry_count > MAX_ENTRIES || h->root_count > h->entry_count) return false;
+			const size_t blocks = (h->entry_count + NAME_BLOCK - 1) / NAME_BLOCK;
+
+			const auto* b = static_cast<const uint8_t*>(data);
+			size_t off = align(sizeof(Header));
+			const auto section = [&](size_t bytes) {
+				const auto* p = b + off;
+				off = align(off + bytes);
+				return p;
+			};
+			es_        = reinterpret_cast<const Entry*>(section(sizeof(Entry) * h->entry_count));
+			name_offs_ = reinterpret_cast<const uint32_t*>(section(sizeof(uint32_t) * (blocks + 1)));
+			keys_      = reinterpret_cast<const uint64_t*>(section(sizeof(uint64_t) * h->key_count));
+			post_offs_ = reinterpret_cast<const uint32_t*>(section(sizeof(uint32_t) * (h->key_count + 1)));
+			post_lens_ = reinterpret_cast<const uint32_t*>(section(sizeof(uint32_t) * h->key_count));
+			if (off > size || h->names_size > size - off) return false;
+			names_     = section(static_cast<size_t>(h->names_size));
+			if (off > size || h->posts_size > size - off) return false;
+			posts_     = section(static_cast<size_t>(h->posts_size));
+			names_end_ = names_ + h->names_size;
+			posts_end_ = posts_ + h->posts_size;
+
+			for (size_t i = 0; i < blocks; ++i) {
+				if (name_offs_[i] > name_offs_[i + 1] || name_offs_[i + 1] > h->names_size) return false;
+			}
+			for (size_t k = 0; k < h->key_count; ++k) {
+				if (post_offs_[k] > post_offs_[k + 1] || post_offs_[k + 1] > h->posts_size || post_lens_[k] > h->entry_count) return false;
+			}
+			for (uint32_t i = 0; i < h->entry_count; ++i) {
+				const auto& e = es_[i];
+				if ((i < h->root_count) != (e.parent == NONE) || (e.parent != NONE && e.parent >= i)) return false;
+				if (e.count != NONE && static_cast<uint64_t>(e.first) + e.count > h->entry_count) return false;
+			}
+			size_       = h->entry_count;
+			root_count_ = h->root_count;
+			key_count_  = h->key_count;
+			return true;
+		}
+
+	public:
+
+		Image() noexcept = default;
+		Image(const Image&) = delete;
+		Image& operator=(const Image&) = delete;
+		Image(Image&&) = delete;
+		Image& operator=(Image&&) = delete;
+		~Image() = default;
+
+		bool map(const std::wstring& file) {
+			return map_.open(file) && attach(map_.data(), map_.size());
+		}
+
+		bool assign(std::string&& bytes) {
+			buf_ = std::move(bytes);
+			return attach(buf_.data(), buf_.size());
+		}
+
+		// Bytes of the image kept in memory
+		std::string_view bytes() const noexcept {
+			return buf_;
+		}
+
+		uint32_t size() const noexcept {
+			return size_;
+		}
+
+		uint32_t root_count() const noexcept {
+			return root_count_;
+		}
+
+		const Entry& entry(uint32_t id) const noexcept {
+			return es_[id];
+		}
+
+		// Call fn with the id and the name of each entry in [first, last), decoded from the head of the block,
+		// while it returns true
+		template<typename F> void each_name(uint32_t first, uint32_t last, F fn) const {
+			std::wstring name;
+			const uint32_t head = first - first % NAME_BLOCK;
+			const uint8_t* p = names_ + name_offs_[head / NAME_BLOCK];
+			for (uint32_t i = head; i < last; ++i) {
+				const auto shared = get_varint(p, names_end_);
+				const auto len    = get_varint(p, names_end_);
+				name.resize((std::min)(static_cast<size_t>(shared), name.size()));
+				for (uint32_t k = 0; k < len && p < names_end_; ++k) name.push_back(static_cast<wchar_t>(get_varint(p, names_end_)));
+				if (i >= first && !fn(i, std::wstring_view{ name })) return;
+			}
+		}
+
+		std::wstring name(uint32_t id) const {
+			std::wstring ret;
+			each_name(id, id + 1, [&](uint32_t, std::wstring_view n) { ret.assign(n); return true; });
+			return ret;
+		}
+
+		// Path of the entry named name, whose folders' paths are kept in dirs for the entries of the same folders
+		std::wstring path(uint32_t id, std::wstring_view name, std::unordered_map<uint32_t, std::wstring>& dirs) const {
+			const auto parent = es_[id].parent;
+			if (parent == NONE) return std::wstring{ name };
+			auto it = dirs.find(parent);
+			if (it == dirs.end()) it = dirs.emplace(parent, path(parent, this->name(parent), dirs)).first;
+			std::wstring ret{ it->second };
+			if (ret.back() != path::PATH_SEPARATOR) ret.push_back(path::PATH_SEPARATOR);
+			return ret.append(name);
+		}
+
+		// Position of the trigram (NONE when no name has it)
+		uint32_t find(uint64_t t) const noexcept {
+			const auto it = std::lower_bound(keys_, keys_ + key_count_, t);
+			return (it != keys_ + key_count_ && *it == t) ? static_cast<uint32_t>(it - keys_) : NONE;
+		}
+
+		uint32_t posting_size(uint32_t k) const noexcept {
+			return post_lens_[k];
+		}
+
+		// Ids of the entries having the trigram, cut at the first one out of the entries in a broken image
+		void postings(uint32_t k, std::vector<uint32_t>& out) const {
+			out.clear();
+			out.reserve(post_lens_[k]);
+			const uint8_t* p = posts_ + post_offs_[k];
+			uint64_t id = 0;
+			for (uint32_t i = 0; i < post_lens_[k]; ++i) {
+				id += get_varint(p, posts_end_);
+				if (id >= size_) break;
+				out.push_back(static_cast<uint32_t>(id));
+			}
+		}
+
+	};
+
+	// Entries being built, with their names in a pool
+	struct Tree {
+		std::vector<Entry>    es;
+		std::vector<uint32_t> offs{ 0 };  // Ranges of the names in the pool
+		std::wstring          pool;
+		uint32_t              root_count{};
+
+		std::wstring_view name(uint32_t id) const noexcept {
+			return { pool.data() + offs[id], offs[id + 1] - offs[id] };
+		}
+
+		uint32_t add(uint32_t parent, std::wstring_view name, uint32_t attr, uint64_t size, uint64_t time) {
+			es.push_back({ parent, 0, NONE, attr, size, time });
+			pool.append(name);
+			offs.push_back(static_cast<uint32_t>(pool.size()));
+			return static_cast<uint32_t>(es.size() - 1);
+		}
+	};
+
+	static wchar_t fold(wchar_t c) noexcept {
+		if (c < 0x80) return (L'A' <= c && c <= L'Z') ? static_cast<wchar_t>(c | 0x20) : c;
+		return static_cast<wchar_t>(std::towlower(c));
+	}
+
+	static uint64_t trigram(wchar_t a, wchar_t b, wchar_t c) noexcept {
+		const auto k = [](wchar_t x) { return static_cast<uint64_t>(x) & 0x1FFFFF; };
+		return (k(a) << 42) | (k(b) << 21) | k(c);
+	}
+
+	// Distinct trigrams of the folded name
+	static void trigrams(std::wstring_view name, std::vector<uint64_t>& out) {
+		out.clear();
+		for (size_t i = 0; i + 2 < name.size(); ++i) out.push_back(trigram(fold(name[i]), fold(name[i + 1]), fold(name[i + 2])));
+		std::sort(out.begin(), out.end());
+		out.erase(std::unique(out.begin(), out.end()), out.end());
+	}
+
+	// Intersection of sorted lists, the first of which is the shorter; ids of the longer are compared four
+	// at once where SSE2 is available
+	static void intersect(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, std::vector<uint32_t>& out) {
+		out.clear();
+		size_t i = 0, j = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+		while (i < a.size() && j + 4 <= b.size()) {  // The ids of b before j are less than a[i]
+			const uint32_t v = a[i];
+			if (b[j + 3] < v) {
+				j += 4;
+				continue;
+			}
+			const auto bs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data() + j));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(bs, _mm_set1_epi32(static_cast<int>(v))))) out.push_back(v);
+			++i;
+		}
+#endif
+		while (i < a.size() && j < b.size()) {
+			if (a[i] < b[j]) ++i;
+			else if (b[j] < a[i]) ++j;
+			else {
+				out.push_back(a[i]);
+				++i;
+				++j;
+			}
+		}
+	}
+
+	// Image of the tree, whose postings are laid out by counting the trigrams of the names first
+	// (empty when it is too large for the offsets)
+	static std::string serialize(const Tree& x) {
+		const auto n = static_cast<uint32_t>(x.es.size());
+		std::unordered_map<uint64_t, uint32_t> count;
+		std::vector<uint64_t> ts;
+		for (uint32_t i = 0; i < n; ++i) {
+			trigrams(x.name(i), ts);
+			for (const auto t : ts) ++count[t];
+		}
+		std::vector<uint64_t> keys;
+		keys.reserve(count.size());
+		for (const auto& [t, c] : count) keys.push_back(t);
+		std::sort(keys.begin(), keys.end());
+		std::vector<uint32_t> lens(keys.size()), cur(keys.size());
+		size_t total = 0;
+		for (uint32_t k = 0; k < keys.size(); ++k) {
+			auto& c = count[keys[k]];
+			lens[k] = c;
+			cur[k]  = static_cast<uint32_t>(total);
+			total  += c;
+			c = k;  // Counted, and now the position of the key
+		}
+		std::vector<uint32_t> ids(total);
+		for (uint32_t i = 0; i < n; ++i) {
+			trigrams(x.name(i), ts);
+			for (const auto t : ts) ids[cur[count[t]]++] = i;
+		}
+
+		std::string posts;
+		std::vector<uint32_t> post_offs{ 0 };
+		for (size_t k = 0, p = 0; k < keys.size(); ++k) {
+			uint32_t prev = 0;
+			for (const auto end = p + lens[k]; p < end; ++p) {
+				put_varint(posts, ids[p] - prev);
+				prev = ids[p];
+			}
+			if (posts.size() > UINT32_MAX) return {};
+			post_offs.push_back(static_cast<uint32_t>(posts.size()));
+		}
+		std::string names;
+		std::vector<uint32_t> name_offs;
+		std::wstring_view prev;
+		for (uint32_t i = 0; i < n; ++i) {
+			const auto name = x.name(i);
+			if (i % NAME_BLOCK == 0) {
+				if (names.size() > UINT32_MAX) return {};
+				name_offs.push_back(static_cast<uint32_t>(names.size()));
+				prev = {};
+			}
+			size_t shared = 0;
+			while (shared < prev.size() && shared < name.size() && prev[shared] == name[shared]) ++shared;
+			put_varint(names, static_cast<uint32_t>(shared));
+			put_varint(names, static_cast<uint32_t>(name.size() - shared));
+			for (size_t k = shared; k < name.size(); ++k) put_varint(names, static_cast<uint32_t>(name[k]));
+			prev = name;
+		}
+		if (names.size() > UINT32_MAX) return {};
+		name_offs.push_back(static_cast<uint32_t>(names.size()));
+
+		Header h{};
+		std::memcpy(&h.magic[0], &MAGIC[0], sizeof(MAGIC));
+		h.version     = VERSION;
+		h.entry_count = n;
+		h.root_count  = x.root_count;
+		h.key_count   = static_cast<uint32_t>(keys.size());
+		h.names_size  = names.size();
+		h.posts_size  = posts.size();
+		std::string out;
+		put(out, &h, 1);
+		put(out, x.es.data(), x.es.size());
+		put(out, name_offs.data(), name_offs.size());
+		put(out, keys.data(), keys.size());
+		put(out, post_offs.data(), post_offs.size());
+		put(out, lens.data(), lens.size());
+		put(out, names.data(), names.size());
+		put(out, posts.data(), posts.size());
+		return out;
+	}
+
+	// Write the image to a temporary file and replace the file by it, since the file may be mapped
+	static bool save(const std::wstring& file, std::string_view bytes) {
+		const auto temp = file + L".tmp";
+		{
+			std::ofstream ofs(os::native_path(temp), std::ios::binary);
+			if (!ofs) return false;
+			ofs.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+			if (!ofs) return false;
+		}
+		return os::replace_file(temp, file);
+	}
+
+	// Shared with the worker, which is left to end by itself when canceled since it may be stuck in a folder
+	// not answering (indexes built by the workers canceled are ignored by the generation)
+	struct State {
+		std::mutex mutex;
+		std::mutex file_mutex;  // Held while the file is written or read, so that workers do not overlap
+		std::shared_ptr<const Image> idx;
+		bool building{};
+		bool tracking{};
+		uint64_t built_at{};
+		uint64_t gen{};
+	};
+
+	// Shared with the worker searching the index (entries found by the searches canceled are ignored by the
+	// generation)
+	struct Search {
+		std::mutex mutex;
+		DirectoryLister::Batch pending;
+		bool done{ true };
+		bool posted{};
+		uint64_t last{};
+		uint64_t gen{};
+		std::function<void()> notify;
+	};
+
+	std::wstring file_;
+	std::vector<std::wstring> roots_;
+	std::shared_ptr<State> st_{ std::make_shared<State>() };
+	std::stop_source stop_;
+	std::shared_ptr<Search> se_{ std::make_shared<Search>() };
+	std::stop_source search_stop_;
+
+	std::shared_ptr<const Image> current() const {
+		std::lock_guard lock(st_->mutex);
+		return st_->idx;
+	}
+
+	// Use the index unless the worker has been canceled (returns false then)
+	static bool publish(State& st, uint64_t gen, std::shared_ptr<const Image> x) {
+		std::lock_guard lock(st.mutex);
+		if (st.gen != gen) return false;
+		st.idx = std::move(x);
+		return true;
+	}
+
+	// Walk the roots breadth first; a folder not changed since the old index takes its children from there
+	// without being listed, which is known by the changes when dirty is given, or by the time of the folder
+	static bool build(std::stop_token st, const std::vector<std::wstring>& roots, const Image* old, Tree& x, ChangeJournal& journal, const std::unordered_set<std::wstring>* dirty) {
+		struct Dir {
+			uint32_t id, old;
+			std::wstring path;
+		};
+		struct Child {
+			std::wstring name;
+			uint32_t attr;
+			uint64_t size;
+			uint64_t time;
+			uint32_t old;  // Entry in the old index
+		};
+		std::deque<Dir> queue;
+		for (const auto& r : roots) {
+			const auto attr = os::file_attributes(r);
+			uint64_t time{};
+			if (attr == os::ATTR_INVALID || !(attr & os::ATTR_DIRECTORY) || !os::file_time(r, time)) continue;
+			uint32_t o = NONE;
+			if (old) {
+				old->each_name(0, old->root_count(), [&](uint32_t i, std::wstring_view n) {
+					if (n == r) o = i;
+					return o == NONE;
+				});
+			}
+			queue.push_back({ x.add(NONE, r, os::ATTR_DIRECTORY, 0, time), o, r });
+		}
+		x.root_count = static_cast<uint32_t>(x.es.size());
+
+		std::vector<Child> cs, olds;
+		while (!queue.empty()) {
+			if (st.stop_requested()) return false;
+			Dir d = std::move(queue.front());
+			queue.pop_front();
+			journal.watch(d.path);
+
+			const bool has_old = d.old != NONE && old->entry(d.old).count != NONE;
+			const bool known   = has_old && dirty && !dirty->contains(ChangeJournal::key(d.path));
+			if (!known && x.es[d.id].parent != NONE && !os::file_time(d.path, x.es[d.id].time)) continue;  // The time of a folder taken from the old index is old
+
+			olds.clear();
+			if (has_old) {
+				const auto& oe = old->entry(d.old);
+				old->each_name(oe.first, oe.first + oe.count, [&](uint32_t i, std::wstring_view n) {
+					const auto& e = old->entry(i);
+					olds.push_back({ std::wstring{ n }, e.attr, e.size, e.time, i });
+					return true;
+				});
+			}
+			cs.clear();
+			if (known || (has_old && old->entry(d.old).time == x.es[d.id].time)) {
+				cs.swap(olds);
+			} else {
+				file_system::find_first_file(d.path, [&](const std::wstring&, const os::FindData& fd) {
+					cs.push_back({ std::wstring{ fd.name }, fd.attr, fd.size, fd.time, NONE });
+					return !st.stop_requested();
+				});
+				std::sort(cs.begin(), cs.end(), [](const Child& a, const Child& b) { return a.name < b.name; });
+				for (auto& c : cs) {
+					const auto it = std::lower_bound(olds.begin(), olds.end(), c.name, [](const Child& a, const std::wstring& n) { return a.name < n; });
+					if (it != olds.end() && it->name == c.name) c.old = it->old;
+				}
+			}
+			if (x.es.size() + cs.size() > MAX_ENTRIES) break;
+
+			x.es[d.id].first = static_cast<uint32_t>(x.es.size());
+			x.es[d.id].count = static_cast<uint32_t>(cs.size());
+			for (const auto& c : cs) {
+				const uint32_t id = x.add(d.id, c.name, c.attr, c.size, c.time);
+				if ((c.attr & os::ATTR_DIRECTORY) && !(c.attr & os::ATTR_REPARSE_POINT)) {
+					std::wstring p{ d.path };
+					if (p.back() != path::PATH_SEPARATOR) p.push_back(path::PATH_SEPARATOR);
+					queue.push_back({ id, c.old, p.append(c.name) });
+				}
+			}
+		}
+		return true;
+	}
+
+	// Build the index; it is used from memory at first, and mapped from the file once it is saved with the
+	// positions of the journals to continue from
+	static void update(State& st, uint64_t gen, std::stop_token stop, const std::wstring& file, const std::vector<std::wstring>& roots, ChangeJournal& journal, const std::unordered_set<std::wstring>* dirty) {
+		std::shared_ptr<const Image> old;
+		{
+			std::lock_guard lock(st.mutex);
+			if (st.gen != gen) return;
+			st.building = true;
+			st.built_at = os::tick_count();
+			old = st.idx;
+		}
+		const auto chk = journal.checkpoint();
+		std::string bytes;
+		{
+			Tree t;
+			if (build(stop, roots, old.get(), t, journal, dirty)) bytes = serialize(t);
+		}
+		auto x = std::make_shared<Image>();
+		if (!bytes.empty() && x->assign(std::move(bytes))) {
+			old.reset();
+			std::lock_guard lock(st.file_mutex);
+			if (publish(st, gen, x) && save(file, x->bytes())) {
+				text_reader_writer::write(file + L".chk", chk);
+				auto m = std::make_shared<Image>();
+				if (m->map(file)) publish(st, gen, std::move(m));
+			}
+		}
+		std::lock_guard lock(st.mutex);
+		if (st.gen == gen) st.building = false;
+	}
+
+	// Build the index, and update it by the folders changed until stopped; all the folders are checked by
+	// their times when changes may have been missed, such as when the changes since the saving are unknown
+	static void run(std::shared_ptr<State> st, uint64_t gen, std::stop_token stop, std::wstring file, std::vector<std::wstring> roots) {
+		os::fail_critical_errors_in_thread();
+		ChangeJournal journal;
+		std::vector<std::wstring> chk;
+		{
+			std::lock_guard lock(st->file_mutex);
+			std::lock_guard l(st->mutex);
+			if (st->idx) chk = text_reader_writer::read(file + L".chk");
+		}
+		const bool known = journal.open(roots, chk);
+		std::vector<std::wstring> dirs;
+		std::unordered_set<std::wstring> dirty;
+		const auto to_dirty = [&] {
+			dirty.clear();
+			for (const auto& d : dirs) dirty.insert(ChangeJournal::key(d));
+			dirs.clear();
+		};
+		const bool complete = journal.take(dirs) && known;
+		to_dirty();
+		update(*st, gen, stop, file, roots, journal, complete ? &dirty : nullptr);
+
+		std::mutex m;
+		std::condition_variable_any cv;
+		uint64_t last = os::tick_count();
+		while (!stop.stop_requested()) {
+			std::unique_lock lock(m);
+			cv.wait_for(lock, stop, std::chrono::milliseconds(POLL_INTERVAL), [] { return false; });
+			if (stop.stop_requested()) break;
+			const bool tracking = journal.take(dirs);
+			{
+				std::lock_guard l(st->mutex);
+				if (st->gen != gen) break;
+				st->tracking = tracking;
+			}
+			if (dirs.empty() || os::tick_count() - last < MIN_UPDATE_INTERVAL) continue;
+			to_dirty();
+			update(*st, gen, stop, file, roots, journal, tracking ? &dirty : nullptr);
+			last = os::tick_count();
+		}
+		journal.close();
+		std::lock_guard lock(st->mutex);
+		if (st->gen == gen) st->building = st->tracking = false;
+	}
+
+	// Call fn with each entry whose name is matched, up to max and while fn returns true, whose name is its
+	// path; a word of three or more characters contained in the names narrows them by the trigrams before
+	// match is called
+	template<typename F> static size_t lookup(const Image& x, std::wstring_view word, const std::function<bool(std::wstring_view)>& match, size_t max, F fn, std::stop_token stop = {}) {
+		if (max == 0) return 0;
+		size_t hits = 0;
+		std::unordered_map<uint32_t, std::wstring> dirs;
+		const auto hit = [&](uint32_t id, std::wstring_view name) {
+			if (stop.stop_requested()) return false;
+			if (!match(name)) return true;
+			const auto& e = x.entry(id);
+			const auto p  = x.path(id, name, dirs);
+			return fn(os::FindData{ p, e.attr, e.size, e.time }) && ++hits < max;
+		};
+		if (word.size() < 3) {
+			x.each_name(0, x.size(), hit);
+			return hits;
+		}
+		std::vector<uint64_t> ts;
+		trigrams(word, ts);
+		std::vector<uint32_t> ks;  // Postings, shortest first
+		for (const auto t : ts) {
+			const auto k = x.find(t);
+			if (k == NONE) return 0;
+			ks.push_back(k);
+		}
+		std::sort(ks.begin(), ks.end(), [&](uint32_t a, uint32_t b) { return x.posting_size(a) < x.posting_size(b); });
+		std::vector<uint32_t> ids, list, temp;
+		x.postings(ks[0], ids);
+		for (size_t l = 1; l < ks.size() && !ids.empty(); ++l) {
+			x.postings(ks[l], list);
+			intersect(ids, list, temp);
+			ids.swap(temp);
+		}
+		for (const auto id : ids) {
+			if (!hit(id, x.name(id))) break;
+		}
+		return hits;
+	}
+
+	// Search the index by the matcher, passing the entries found on at intervals
+	static void find(std::shared_ptr<Search> se, uint64_t gen, std::stop_token stop, std::shared_ptr<const Image> x, std::unique_ptr<Matcher> m, size_t max) {
+		if (x) {
+			lookup(*x, m->literal(), [&](std::wstring_view name) { return m->match(name); }, max, [&](const os::FindData& fd) {
+				std::function<void()> notify;
+				{
+					std::lock_guard lock(se->mutex);
+					if (se->gen != gen) return false;  // Canceled
+					se->pending.add(fd);
+					const auto now = os::tick_count();
+					if (!se->posted && now - se->last >= NOTIFY_INTERVAL) {
+						se->posted = true;
+						se->last   = now;
+						notify     = se->notify;
+					}
+				}
+				if (notify) notify();
+				return true;
+			}, stop);
+		}
+		std::function<void()> notify;
+		{
+			std::lock_guard lock(se->mutex);
+			if (se->gen != gen) return;
+			se->done = true;
+			if (!se->posted) {
+				se->posted = true;
+				notify = se->notify;
+			}
+		}
+		if (notify) notify();
+	}
+
+public:
+
+	PathIndex() noexcept = default;
+	PathIndex(const PathIndex&) = delete;
+	PathIndex& operator=(const PathIndex&) = delete;
+	PathIndex(PathIndex&&) = delete;
+	PathIndex& operator=(PathIndex&&) = delete;
+
+	~PathIndex() {
+		cancel();
+		cancel_search();
+		std::lock_guard lock(se_->mutex);
+		se_->notify = nullptr;
+	}
+
+	// Set the function called from the worker searching the index when entries found are ready to be taken
+	void set_notifier(std::function<void()> fn) {
+		std::lock_guard lock(se_->mutex);
+		se_->notify = std::move(fn);
+	}
+
+	// Build the index of the folders in the background, and keep it updated by the changes of the folders;
+	// the index saved in the file is mapped at once and used until it is built, and the folders not changed
+	// since then are not listed again
+	void start(const std::wstring& file, std::vector<std::wstring> roots) {
+		cancel();
+		if (file != file_) {
+			file_ = file;
+			auto x = std::make_shared<Image>();
+			if (!x->map(file_)) x.reset();
+			std::lock_guard lock(st_->mutex);
+			st_->idx = std::move(x);
+		}
+
+		// Folders below another root are indexed with it
+		std::sort(roots.begin(), roots.end());
+		roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+		std::vector<std::wstring> rs;
+		for (auto& r : roots) {
+			if (!rs.empty()) {
+				std::wstring p{ rs.back() };
+				if (p.back() != path::PATH_SEPARATOR) p.push_back(path::PATH_SEPARATOR);
+				if (r.starts_with(p)) continue;
+			}
+			rs.push_back(std::move(r));
+		}
+		roots_ = rs;
+		uint64_t gen;
+		{
+			std::lock_guard lock(st_->mutex);
+			st_->building = true;
+			st_->built_at = os::tick_count();
+			gen = st_->gen;
+		}
+		stop_ = std::stop_source{};
+		std::thread(run, st_, gen, stop_.get_token(), file_, std::move(rs)).detach();
+	}
+
+	// Stop building and updating the index without waiting for the worker; the index built so far is kept
+	void cancel() {
+		stop_.request_stop();
+		std::lock_guard lock(st_->mutex);
+		++st_->gen;
+		st_->building = st_->tracking = false;
+	}
+
+	bool is_building() const {
+		std::lock_guard lock(st_->mutex);
+		return st_->building;
+	}
+
+	// Whether the index is updated by all the changes of the folders
+	bool is_tracking() const {
+		std::lock_guard lock(st_->mutex);
+		return st_->tracking;
+	}
+
+	// Time passed since the last build was started [ms]
+	uint64_t age() const {
+		std::lock_guard lock(st_->mutex);
+		return os::tick_count() - st_->built_at;
+	}
+
+	const std::vector<std::wstring>& roots() const noexcept {
+		return roots_;
+	}
+
+	// Number of the folders and files indexed
+	size_t size() const {
+		const auto x = current();
+		return x ? x->size() : 0;
+	}
+
+	// Call fn with each entry whose name is matched, up to max, whose name is its path; a word of three or
+	// more characters contained in the names narrows them by the trigrams before match is called
+	template<typename F> size_t query(std::wstring_view word, const std::function<bool(std::wstring_view)>& match, size_t max, F fn) const {
+		const auto x = current();
+		return x ? lookup(*x, word, match, max, [&](const os::FindData& fd) { fn(fd); return true; }) : 0;
+	}
+
+	// Search the index in the background for the entries whose names match the matcher made by setup, up to
+	// max (the previous search is canceled); the entries found are named by their paths
+	void search(const std::function<void(Matcher&)>& setup, size_t max) {
+		cancel_search();
+		auto m = std::make_unique<Matcher>();
+		setup(*m);
+		uint64_t gen;
+		{
+			std::lock_guard lock(se_->mutex);
+			se_->pending.clear();
+			se_->done   = false;
+			se_->posted = false;
+			se_->last   = os::tick_count();
+			gen = se_->gen;
+		}
+		search_stop_ = std::stop_source{};
+		std::thread(find, se_, gen, search_stop_.get_token(), current(), std::move(m), max).detach();
+	}
+
+	// Stop the current search without waiting for it and discard the entries not taken
+	void cancel_search() {
+		search_stop_.request_stop();
+		std::lock_guard lock(se_->mutex);
+		++se_->gen;
+		se_->pending.clear();
+		se_->done = true;
+	}
+
+	// Take the entries found so far (returns true when the search is done)
+	bool take(DirectoryLister::Batch& out) {
+		out.clear();
+		std::lock_guard lock(se_->mutex);
+		std::swap(out, se_->pending);
+		se_->posted = false;
+		return se_->done;
+	}
+
+};
@@ -2,7 +2,7 @@
  * Popup Menu
  *
  * @author Takuto Yanagida
- * @version 2026-05-13
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -70,10 +70,11 @@ class PopupMenu {
 		std::wstring path;
 
 		const auto dir = path::parent(pref_.path()) + L"\\newfile\\";
-		file_system::find_first_file(dir, [&](const std::wstring& parent, const WIN32_FIND_DATA& wfd) {
-			path.assign(L"<CreateNew>").append(parent).append(&wfd.cFileName[0]);
+		file_system::find_first_file(dir, [&](const std::wstring& parent, const os::FindData& fd) {
+			const std::wstring name{ fd.name };
+			path.assign(L"<CreateNew>").append(parent).append(name);
 			items.push_back(path);
-			::AppendMenu(hMenu, MF_STRING, items.size(), &wfd.cFileName[0]);
+			::AppendMenu(hMenu, MF_STRING, items.size(), name.c_str());
 			return true;  // continue
 		});
 	}
@@ -2,7 +2,7 @@
  * Preference (Reading and writing INI file)
  *
  * @author Takuto Yanagida
- * @version 2025-11-19
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -11,34 +11,23 @@
 #include <string>
 #include <sstream>
 
-#include <windows.h>
-
 #include "classes.h"
-#include "file_utils.hpp"
+#include "os.hpp"
+#include "path.hpp"
+#include "file_system.hpp"
 
 class Pref {
 
 	std::wstring path_;
 	std::wstring cur_sec_;
 
-	static std::wstring get_user_name() {
-		DWORD bufLen = MAX_PATH;
-		std::vector<wchar_t> buf(bufLen);
-
-		while (true) {
-			::GetUserName(buf.data(), &bufLen);
-			if (::GetLastError() != ERROR_INSUFFICIENT_BUFFER) break;
-			bufLen *= 2;
-			buf.resize(bufLen);
-		}
-		return std::wstring{ buf.data() };
-	}
-
 public:
 
 	Pref() noexcept {
 		path_ = file_system::module_file_path();
-		path_.resize(path_.size() - 3);
+		const auto ext = path::ext(path_);
+		path_.resize(path_.size() - ext.size());
+		if (ext.empty()) path_.append(1, path::EXT_PREFIX);
 		path_.append(L"ini");
 	}
 
@@ -50,14 +39,14 @@ public:
 		// Create INI file path for current user
 		auto name = path::name(normalPath);
 		auto path = path::parent(normalPath);
-		auto user = get_user_name();
-		path.append(L"\\").append(user);
-		path_.assign(path).append(L"\\").append(name);
+		auto user = os::user_name();
+		path.append(1, path::PATH_SEPARATOR).append(user);
+		path_.assign(path).append(1, path::PATH_SEPARATOR).append(name);
 
 		// When a normal INI file exists and there is no INI file for the current user
 		if (file_system::is_existing(normalPath) && !file_system::is_existing(path_)) {
-			::CreateDirectory(path.c_str(), nullptr);  // Make a directory
-			::CopyFile(normalPath.c_str(), path_.c_str(), TRUE);  // Copy
+			os::create_directory(path);  // Make a directory
+			os::copy_file(normalPath, path_, true);  // Copy
 		}
 	}
 
@@ -69,16 +58,7 @@ public:
 
 	// Get string item
 	std::wstring item(const wchar_t* sec, const wchar_t* key, const wchar_t* def) const {
-		std::vector<wchar_t> buf(MAX_PATH);
-		DWORD nSize{ MAX_PATH };
-
-		while (true) {
-			const auto outLen = ::GetPrivateProfileString(sec, key, def, buf.data(), nSize, path_.c_str());
-			if (outLen != buf.size() - 1) break;
-			nSize *= 2;
-			buf.resize(nSize);
-		}
-		return { buf.data() };
+		return os::profile_string(path_, sec, key, def);
 	}
 
 	// Get string item
@@ -98,7 +78,10 @@ public:
 
 	// Write a string item
 	void set_item(const std::wstring& str, const std::wstring& sec, const std::wstring& key) noexcept {
-		::WritePrivateProfileString(sec.c_str(), key.c_str(), str.c_str(), path_.c_str());
+		try {
+			os::set_profile_string(path_, sec.c_str(), key.c_str(), str.c_str());
+		} catch (...) {
+		}
 	}
 
 	// Write a string item
@@ -109,7 +92,11 @@ public:
 	// Get integer item
 	int item_int(const wchar_t* sec, const wchar_t* key, int def) noexcept {
 		if (sec == nullptr || key == nullptr) return def;
-		return ::GetPrivateProfileInt(sec, key, def, path_.c_str());
+		try {
+			return os::profile_int(path_, sec, key, def);
+		} catch (...) {
+			return def;
+		}
 	}
 
 	// Get integer item
@@ -130,7 +117,7 @@ public:
 	// Write an integer item
 	void set_item_int(const std::wstring& sec, const std::wstring& key, int val) noexcept {
 		try {
-			::WritePrivateProfileString(sec.c_str(), key.c_str(), std::to_wstring(val).c_str(), path_.c_str());
+			os::set_profile_string(path_, sec.c_str(), key.c_str(), std::to_wstring(val).c_str());
 		} catch (...) {
 		}
 	}
@@ -155,7 +142,7 @@ public:
 
 	// Write the content of the section
 	template <typename Container> void set_items(const Container& c, const std::wstring& sec, const std::wstring& key) {
-		::WritePrivateProfileString(sec.c_str(), nullptr, nullptr, path_.c_str());
+		os::set_profile_string(path_, sec.c_str(), nullptr, nullptr);
 		int i = 0;
 		for (const auto& it : c) {
 			std::wostringstream vss;
@@ -0,0 +1,100 @@
+/**
+ * Regex Generator (Pattern Matching Any of the Words Added)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+class RegexGenerator {
+
+	struct Node {
+		wchar_t c;
+		bool end;
+		std::vector<uint32_t> children;  // Sorted by characters
+	};
+
+	std::vector<Node> ns_{ Node{ 0, false, {} } };  // The first is the root
+
+	static void escape(std::wstring& out, wchar_t c, bool in_class) {
+		const std::wstring_view sc = in_class ? L"\\]^-[" : L"\\^$.|?*+()[]{}/";
+		if (sc.find(c) != std::wstring_view::npos) out.push_back(L'\\');
+		out.push_back(c);
+	}
+
+	// Leaves become a bracket expression, and the others become alternatives following their characters
+	void generate(uint32_t n, std::wstring& out) const {
+		const auto& cs = ns_[n].children;
+		const auto leaves = static_cast<size_t>(std::count_if(cs.begin(), cs.end(), [&](uint32_t c) { return ns_[c].end; }));
+		const auto alts   = (leaves ? 1 : 0) + (cs.size() - leaves);
+		if (alts > 1) out.push_back(L'(');
+		bool first = true;
+		if (leaves == 1) {
+			for (const auto c : cs) if (ns_[c].end) escape(out, ns_[c].c, false);
+			first = false;
+		} else if (leaves > 1) {
+			out.push_back(L'[');
+			for (const auto c : cs) if (ns_[c].end) escape(out, ns_[c].c, true);
+			out.push_back(L']');
+			first = false;
+		}
+		for (const auto c : cs) {
+			if (ns_[c].end) continue;
+			if (!first) out.push_back(L'|');
+			escape(out, ns_[c].c, false);
+			generate(c, out);
+			first = false;
+		}
+		if (alts > 1) out.push_back(L')');
+	}
+
+public:
+
+	RegexGenerator() = default;
+	RegexGenerator(const RegexGenerator&) = delete;
+	RegexGenerator& operator=(const RegexGenerator&) = delete;
+	RegexGenerator(RegexGenerator&&) = delete;
+	RegexGenerator& operator=(RegexGenerator&&) = delete;
+	~RegexGenerator() = default;
+
+	// Add a word; a word having another as its prefix is not needed since patterns match anywhere
+	void add(std::wstring_view word) {
+		if (word.empty()) return;
+		uint32_t n = 0;
+		for (const wchar_t c : word) {
+			if (ns_[n].end) return;
+			auto& cs = ns_[n].children;
+			const auto it = std::lower_bound(cs.begin(), cs.end(), c, [&](uint32_t i, wchar_t d) { return ns_[i].c < d; });
+			if (it != cs.end() && ns_[*it].c == c) {
+				n = *it;
+				continue;
+			}
+			const auto child = static_cast<uint32_t>(ns_.size());
+			cs.insert(it, child);
+			ns_.push_back({ c, false, {} });
+			n = child;
+		}
+		ns_[n].end = true;
+		ns_[n].children.clear();
+	}
+
+	void clear() {
+		ns_.resize(1);
+		ns_[0].children.clear();
+	}
+
+	// Pattern of the words added (empty when no word was added)
+	std::wstring generate() const {
+		std::wstring out;
+		generate(0, out);
+		return out;
+	}
+
+};
@@ -2,7 +2,7 @@
  * Rename Edit
  *
  * @author Takuto Yanagida
- * @version 2026-05-13
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -87,7 +87,7 @@ public:
 		auto fname = path::name(renamed_path_);
 
 		auto len = fname.size();
-		if (link::is_link(renamed_path_)) {
+		if (shortcut::is_link(renamed_path_)) {
 			fname.resize(fname.size() - 4);  // If it is a shortcut, remove the extension from the file name
 		} else {
 			auto exe = path::ext(fname);
@@ -113,7 +113,7 @@ public:
 		auto fname = std::vector<wchar_t>(gsl::narrow<size_t>(len) + 1);  // Add terminal NULL
 		::GetWindowText(edit_, fname.data(), len + 1);  // Add terminal NULL
 		new_file_name_.assign(fname.data());
-		if (link::is_link(renamed_path_)) {
+		if (shortcut::is_link(renamed_path_)) {
 			new_file_name_.append(_T(".lnk"));
 		}
 		::SendMessage(wnd_, msg_, 0, 0);
@@ -2,7 +2,7 @@
  * Search Functions
  *
  * @author Takuto Yanagida
- * @version 2025-11-20
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -11,12 +11,13 @@
 #include <string>
 #include <algorithm>
 #include <optional>
-#include <regex>
 #include <chrono>
 
 #include "gsl/gsl"
 #include "item_list.h"
-#include "migemo_wrapper.h"
+#include "matcher.h"
+#include "fuzzy_scorer.h"
+#include "migemo_engine.h"
 #include "pref.hpp"
 
 class Search {
@@ -28,35 +29,58 @@ class Search {
 		return gsl::narrow<unsigned long long>(ms);
 	}
 
-	static std::wstring escape_regex_special_chars(const std::wstring& s) {
-		std::wstring res;
-		const std::wstring scs = L"\\^$.|?*+()[]{}/";
-
-		for (const wchar_t c : s) {
-			if (scs.find(c) != std::wstring::npos) {
-				res += L'\\';
-			}
-			res += c;
+	// Names hit by the Migemo pattern, such as those in kana, are ranked above the fuzzy matches of the romaji
+	inline static const int BONUS_MIGEMO = 64;
+
+	MigemoEngine        migemo_;
+	unsigned long long  last_key_search_time_ = 0;
+	bool                use_migemo_           = false;
+	bool                reserve_find_         = false;
+	bool                filter_mode_          = false;
+	bool                fuzzy_mode_           = false;
+	bool                literal_              = false;
+	std::wstring        search_word_;
+	std::wstring        filter_word_;
+	std::wstring        migemo_pattern_;
+	std::wstring        compiled_;  // Word compiled into matcher_
+	Matcher             matcher_;
+	FuzzyScorer         fuzzy_;
+	std::vector<size_t> ranked_;  // Indexes of the items found by find_first in the order of the scores
+
+	// Compile the word into the matcher, which is reused until the word changes
+	void compile(const std::wstring& word) {
+		if (use_migemo_) {
+			migemo_.query(word, migemo_pattern_);
 		}
-		return res;
+		literal_ = !use_migemo_ || !matcher_.set_pattern(migemo_pattern_);
+		if (literal_) {
+			matcher_.set_literal(word);
+		}
+		if (fuzzy_mode_) fuzzy_.set_word(word);
+		compiled_ = word;
 	}
 
-	Migemo             migemo_;
-	unsigned long long last_key_search_time_ = 0;
-	bool               use_migemo_           = false;
-	bool               reserve_find_         = false;
-	std::wstring       search_word_;
-	std::wstring       migemo_pattern_;
-
 public:
 
 	Search() noexcept = default;
 
-	bool initialize(bool use_migemo) {
-		use_migemo_ = (use_migemo && migemo_.load_library());
+	bool initialize(bool use_migemo, bool filter_mode = false, bool fuzzy_mode = false, const std::wstring& migemo_cache = std::wstring()) {
+		use_migemo_  = (use_migemo && migemo_.load(std::wstring(), migemo_cache));
+		filter_mode_ = filter_mode;
+		fuzzy_mode_  = fuzzy_mode;
 		return use_migemo_;
 	}
 
+	// Whether names are ranked by fuzzy matching instead of being hit by the word
+	bool is_fuzzy_mode() const noexcept {
+		return fuzzy_mode_;
+	}
+
+	// Whether key input filters the file list instead of moving the cursor
+	bool is_filter_mode() const noexcept {
+		return filter_mode_;
+	}
+
 	// Key input search
 	void key_search(wchar_t key) {
 		const auto time = get_elapsed_time_ms();
@@ -76,27 +100,35 @@ public:
 		return false;
 	}
 
+	// Find the item matching the word next to the cursor, or the best ranked item in fuzzy mode
 	std::optional<size_t> find_first(std::optional<size_t> cursor_idx, const ItemList& items) {
 		reserve_find_ = false;
-		if (use_migemo_) {
-			migemo_.query(search_word_, migemo_pattern_);
+		compile(search_word_);
+		if (fuzzy_mode_) {
+			rank(items, ranked_);
+			if (ranked_.empty()) return std::nullopt;
+			return ranked_.front();
 		}
 		return find_next(cursor_idx, items);
 	}
 
 	std::optional<size_t> find_next(std::optional<size_t> cursor_idx, const ItemList& items) const {
+		if (fuzzy_mode_) {  // The item ranked next to the one at the cursor
+			const auto it = cursor_idx ? std::find(ranked_.begin(), ranked_.end(), cursor_idx.value()) : ranked_.end();
+			for (auto i = (it == ranked_.end()) ? ranked_.begin() : it + 1; i != ranked_.end(); ++i) {
+				if (*i < items.size()) return *i;
+			}
+			for (const auto i : ranked_) {
+				if (i < items.size()) return i;
+			}
+			return std::nullopt;
+		}
 		std::optional<size_t> jump_to;
 		bool restart = false;
 
 		size_t start_idx = (!cursor_idx) ? 0 : cursor_idx.value() + 1;
 		if (start_idx == items.size()) start_idx = 0;
 
-		std::wregex pat;
-		if (use_migemo_) {
-			pat.assign(migemo_pattern_, std::regex_constants::ECMAScript | std::regex_constants::icase);
-		} else {
-			pat.assign(escape_regex_special_chars(search_word_), std::regex_constants::ECMAScript | std::regex_constants::icase);
-		}
 		for (size_t i = start_idx; ; ++i) {
 			if (i >= items.size()) {
 				i = 0;
@@ -104,7 +136,7 @@ public:
 			}
 			if (restart && i == start_idx) break;
 
-			if (std::regex_search(items.at(i)->name(), pat)) {
+			if (matcher_.match(items.at(i).name())) {
 				jump_to = i;
 				break;
 			}
@@ -112,4 +144,73 @@ public:
 		return jump_to;
 	}
 
+	// Extend the filter word by a key
+	void filter_key(wchar_t key) {
+		filter_word_.append(1, key);
+		compile(filter_word_);
+	}
+
+	// Shorten the filter word (returns false when it becomes empty)
+	bool filter_back() {
+		if (!filter_word_.empty()) filter_word_.pop_back();
+		if (filter_word_.empty()) return false;
+		compile(filter_word_);
+		return true;
+	}
+
+	void clear_filter() noexcept {
+		filter_word_.clear();
+	}
+
+	const std::wstring& filter_word() const noexcept {
+		return filter_word_;
+	}
+
+	// Whether the word compiled last is matched as it is, not by its Migemo pattern; only then are the names
+	// matching the word extended by a key among those matching it now
+	bool is_literal() const noexcept {
+		return literal_;
+	}
+
+	bool match(std::wstring_view name) const {
+		return matcher_.match(name);
+	}
+
+	// Compile the word typed so far (the filter word in filter mode) to search with it elsewhere
+	// (returns false when it is empty)
+	bool prepare() {
+		reserve_find_ = false;
+		const auto& word = filter_mode_ ? filter_word_ : search_word_;
+		if (word.empty()) return false;
+		compile(word);
+		return true;
+	}
+
+	// Compile the word compiled last into another matcher, such as those of worker threads
+	void compile_into(Matcher& m) const {
+		if (!use_migemo_ || !m.set_pattern(migemo_pattern_)) {
+			m.set_literal(compiled_);
+		}
+	}
+
+	// Score of the name with the mask of its characters by fuzzy matching of the word and by the Migemo
+	// pattern (0 when neither matches)
+	int score(std::wstring_view name, uint64_t mask = ~uint64_t{}) const {
+		int s = fuzzy_.score(name, mask);
+		if (use_migemo_ && matcher_.match(name)) s += BONUS_MIGEMO;
+		return s;
+	}
+
+	// Indexes of the items scored above zero, in the descending order of the scores
+	void rank(const ItemList& items, std::vector<size_t>& out) const {
+		std::vector<std::pair<int, size_t>> ss;
+		for (size_t i = 0; i < items.size(); ++i) {
+			const auto it = items.at(i);
+			if (const int s = score(it.name(), it.char_mask()); s > 0) ss.emplace_back(s, i);
+		}
+		std::stable_sort(ss.begin(), ss.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+		out.clear();
+		for (const auto& [s, i] : ss) out.push_back(i);
+	}
+
 };
@@ -2,7 +2,7 @@
  * File Operations
  *
  * @author Takuto Yanagida
- * @version 2026-04-29
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -10,14 +10,21 @@
 #include <windows.h>
 #include <vector>
 #include <string>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <stop_token>
 
 #include "tracker.h"
 #include "file_utils.hpp"
+#include "size_calculator.h"
 #include "type_table.h"
 #include "pref.hpp"
 
 class Selection {
 
+	inline static const size_t SIZE_STR_WIDTH = 29;  // Characters of the longest size string like '>999.9 MB (999,999,999 Bytes)'
+
 	HWND wnd_ = nullptr;
 	std::vector<std::wstring> objects_;
 	std::wstring default_opener_;
@@ -26,6 +33,17 @@ class Selection {
 	const TypeTable& exts_;
 	const Pref& pref_;
 
+	// Shared with the calculation of the size, which is stopped and left to end by itself when it is canceled
+	struct Sizing {
+		SizeCalculator calc;
+		std::stop_source stop;
+		std::atomic<bool> done{};
+		bool suc{};
+		uint64_t size{};
+	};
+
+	std::shared_ptr<Sizing> sizing_;
+
 	// Open file (specify target)
 	bool open_file(const std::vector<std::wstring>& objs) {
 		const auto& obj = objs.front();
@@ -106,10 +124,10 @@ public:
 
 	// Resolve the shortcut and then open
 	bool open_after_resolve() {
-		if (!link::is_link(objects_.front())) return false;  // If it is not a shortcut
+		if (!shortcut::is_link(objects_.front())) return false;  // If it is not a shortcut
 
 		// OpenBy processing
-		auto path = link::resolve(objects_.front());
+		auto path = shortcut::resolve(objects_.front());
 		return open_file({ path });
 	}
 
@@ -175,10 +193,10 @@ public:
 		bool ret = false;
 
 		for (auto& obj : objects_) {
-			auto [target, path] = link::is_link(obj)
-				? std::pair{ link::resolve(obj), obj }
+			auto [target, path] = shortcut::is_link(obj)
+				? std::pair{ shortcut::resolve(obj), obj }
 				: std::pair{ obj, obj + L".lnk" };
-			if (link::create(file_system::unique_name(path), target)) {
+			if (shortcut::create(file_system::unique_name(path), target)) {
 				ret = true;
 			}
 		}
@@ -228,8 +246,9 @@ public:
 		return operation::rename(path, new_file_name);
 	}
 
-	// Get file information string
-	void create_information_strings(std::vector<std::wstring>& items) {
+	// Get file information string; the modified time is that of the first file listed (0 when not known)
+	// For normal files, the size on the first line is calculated in the background (returns true then)
+	bool create_information_strings(std::vector<std::wstring>& items, uint64_t mtime) {
 		if (path::is_root(objects_.front())) {  // When it is a drive
 			uint64_t dsize, dfree;
 			file_system::drive_size(objects_.front(), dsize, dfree);
@@ -237,22 +256,50 @@ public:
 			auto used_str = info::file_size_to_str(dsize - dfree, true, L"");
 			items.push_back(used_str.append(1, L'/').append(size_str));
 			items.push_back(info::file_size_to_str(dfree, true, L"Free: "));
-		} else {  // When it is a normal file
+			return false;
+		}
+		// When it is a normal file
+		start_size_calculation();
+		items.push_back(std::wstring(L"Size:\t...").append(SIZE_STR_WIDTH - 3, L'\u2007'));  // Width of the menu is fixed when shown
+
+		// Get date
+		WIN32_FILE_ATTRIBUTE_DATA fad;
+		if (::GetFileAttributesEx(objects_.front().c_str(), GetFileExInfoStandard, &fad)) {
 			std::wstring ct_str, mt_str;
-			uint64_t size;
-			const bool suc = file_system::calc_file_size(objects_, size, ::GetTickCount64() + 1000);
-			items.push_back(info::file_size_to_str(size, suc, L"Size:\t"));
-
-			// Get date
-			HANDLE hf = ::CreateFile(objects_.front().c_str(), 0, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_BACKUP_SEMANTICS, nullptr);
-			if (hf != INVALID_HANDLE_VALUE) {
-				FILETIME ctime, mtime;
-				::GetFileTime(hf, &ctime, nullptr, &mtime);
-				::CloseHandle(hf);
-				items.push_back(info::file_time_to_str(ctime, L"Created:\t", ct_str));
-				items.push_back(info::file_time_to_str(mtime, L"Modified:\t", mt_str));
+			FILETIME mt = fad.ftLastWriteTime;
+			if (mtime) {
+				mt.dwLowDateTime  = static_cast<DWORD>(mtime);
+				mt.dwHighDateTime = static_cast<DWORD>(mtime >> 32);
 			}
+			items.push_back(info::file_time_to_str(fad.ftCreationTime, L"Created:\t", ct_str));
+			items.push_back(info::file_time_to_str(mt, L"Modified:\t", mt_str));
 		}
+		return true;
+	}
+
+	// Start calculating the total size of the files in the background
+	void start_size_calculation() {
+		sizing_ = std::make_shared<Sizing>();
+		std::thread([s = sizing_, objs = objects_] {
+			os::fail_critical_errors_in_thread();
+			s->suc  = s->calc.calc(objs, s->size, 0, sort_engine::thread_count(), s->stop.get_token());
+			s->done = true;
+		}).detach();
+	}
+
+	// Get the string of the size calculated so far (returns true when the calculation is done)
+	bool size_string(std::wstring& str) const {
+		if (!sizing_) return false;
+		const bool done = sizing_->done;
+		str = done ? info::file_size_to_str(sizing_->size, sizing_->suc, L"Size:\t") : info::file_size_to_str(sizing_->calc.counted(), false, L"Size:\t");
+		return done;
+	}
+
+	// Stop the calculation of the size without waiting for it; its result is ignored, while the sizes of
+	// the folders done are cached
+	void cancel_size_calculation() noexcept {
+		if (sizing_) sizing_->stop.request_stop();
+		sizing_.reset();
 	}
 
 	// Perform processing after update notification
@@ -0,0 +1,210 @@
+/**
+ * Shell Link (Reading Targets of Shortcut Files in MS-SHLLINK Format)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+#include "os.hpp"
+#include "mapped_file.h"
+
+namespace shell_link {
+
+	constexpr uint32_t HEADER_SIZE = 0x4C;
+
+	// Link flags
+	constexpr uint32_t HAS_LINK_TARGET_ID_LIST = 0x0001;
+	constexpr uint32_t HAS_LINK_INFO           = 0x0002;
+	constexpr uint32_t HAS_NAME                = 0x0004;
+	constexpr uint32_t HAS_RELATIVE_PATH       = 0x0008;
+	constexpr uint32_t HAS_WORKING_DIR         = 0x0010;
+	constexpr uint32_t HAS_ARGUMENTS           = 0x0020;
+	constexpr uint32_t HAS_ICON_LOCATION       = 0x0040;
+	constexpr uint32_t IS_UNICODE              = 0x0080;
+	constexpr uint32_t FORCE_NO_LINK_INFO      = 0x0100;
+	constexpr uint32_t HAS_EXP_STRING          = 0x0200;
+
+	constexpr uint32_t ENVIRONMENT_VARIABLE_DATA_BLOCK = 0xA0000001;
+	constexpr uint32_t FILE_ENTRY_EXTENSION_BLOCK      = 0xBEEF0004;
+
+	constexpr std::string_view LINK_CLSID{ "\x01\x14\x02\x00\x00\x00\x00\x00\xC0\x00\x00\x00\x00\x00\x00\x46", 16 };
+
+	namespace detail {
+
+		// Little-endian integers; false when they are out of the data
+		inline bool u16(std::string_view d, size_t off, uint32_t& v) noexcept {
+			if (off > d.size() || d.size() - off < 2) return false;
+			v = static_cast<uint8_t>(d[off]) | (static_cast<uint8_t>(d[off + 1]) << 8);
+			return true;
+		}
+
+		inline bool u32(std::string_view d, size_t off, uint32_t& v) noexcept {
+			uint32_t lo, hi;
+			if (!u16(d, off, lo) || !u16(d, off + 2, hi)) return false;
+			v = lo | (hi << 16);
+			return true;
+		}
+
+		// String of the code page of the system; ASCII is decoded directly
+		inline std::wstring from_ansi(std::string_view s) {
+			std::wstring ret;
+			bool ascii = true;
+			for (const auto c : s) ascii = ascii && static_cast<uint8_t>(c) < 0x80;
+			if (!ascii) {
+				const std::string z{ s };
+				const int len = os::multi_byte_to_wide(z.c_str(), nullptr, 0);
+				if (len > 0) {
+					ret.resize(static_cast<size_t>(len));
+					os::multi_byte_to_wide(z.c_str(), ret.data(), len);
+					ret.resize(static_cast<size_t>(len) - 1);
+					return ret;
+				}
+			}
+			for (const auto c : s) ret.push_back(static_cast<wchar_t>(static_cast<uint8_t>(c)));  // As Latin-1 when not decoded
+			return ret;
+		}
+
+		// Null-terminated strings at the offset (empty when not terminated in the data)
+		inline std::wstring ansi_at(std::string_view d, size_t off) {
+			if (off >= d.size()) return {};
+			const auto end = d.find('\0', off);
+			if (end == std::string_view::npos) return {};
+			return from_ansi(d.substr(off, end - off));
+		}
+
+		inline std::wstring unicode_at(std::string_view d, size_t off) {
+			for (size_t i = off; i + 1 < d.size(); i += 2) {
+				if (d[i] == '\0' && d[i + 1] == '\0') return os::from_utf16le(d.substr(off, i - off));
+			}
+			return {};
+		}
+
+		inline std::wstring join(std::wstring base, const std::wstring& suffix) {
+			if (base.empty() || suffix.empty()) return base.append(suffix);
+			if (base.back() != L'\\') base.push_back(L'\\');
+			return base.append(suffix);
+		}
+
+		// Path of the local or the network volume in the LinkInfo structure
+		inline std::wstring link_info_path(std::string_view li) {
+			uint32_t hs, flags, lbp, cnrl, cps, lbp_u = 0, cps_u = 0;
+			if (!u32(li, 4, hs) || !u32(li, 8, flags) || !u32(li, 16, lbp) || !u32(li, 20, cnrl) || !u32(li, 24, cps)) return {};
+			if (hs >= 0x24 && (!u32(li, 28, lbp_u) || !u32(li, 32, cps_u))) return {};
+			const auto suffix = cps_u ? unicode_at(li, cps_u) : ansi_at(li, cps);
+
+			if (flags & 0x1) {  // VolumeIDAndLocalBasePath
+				return join(lbp_u ? unicode_at(li, lbp_u) : ansi_at(li, lbp), suffix);
+			}
+			if (flags & 0x2) {  // CommonNetworkRelativeLinkAndPathSuffix
+				if (cnrl >= li.size()) return {};
+				const auto nl = li.substr(cnrl);
+				uint32_t net, net_u = 0;
+				if (!u32(nl, 8, net)) return {};
+				if (net > 0x14 && !u32(nl, 20, net_u)) return {};
+				return join(net_u ? unicode_at(nl, net_u) : ansi_at(nl, net), suffix);
+			}
+			return {};
+		}
+
+		// Name of a file entry item, the long one in its extension block if any
+		inline std::wstring file_entry_name(std::string_view item) {
+			const bool unicode = (static_cast<uint8_t>(item[2]) & 0x04) != 0;
+			uint32_t ext_off, sig, ver;
+			if (u16(item, item.size() - 2, ext_off) && ext_off > 14 && ext_off < item.size()) {
+				const auto ext = item.substr(ext_off);
+				if (u32(ext, 4, sig) && sig == FILE_ENTRY_EXTENSION_BLOCK && u16(ext, 2, ver) && ver >= 3) {
+					const size_t name_off = (ver >= 9) ? 46 : (ver == 8) ? 42 : (ver == 7) ? 38 : 20;
+					if (auto name = unicode_at(ext, name_off); !name.empty()) return name;
+				}
+			}
+			return unicode ? unicode_at(item, 14) : ansi_at(item, 14);
+		}
+
+		// Path of the shell items when they are a volume and file entries
+		inline std::wstring id_list_path(std::string_view ids) {
+			std::wstring path;
+			for (size_t pos = 0; ; ) {
+				uint32_t size;
+				if (!u16(ids, pos, size)) return {};
+				if (size == 0) break;
+				if (size < 3 || size > ids.size() - pos) return {};
+				const auto item = ids.substr(pos, size);
+				const auto type = static_cast<uint8_t>(item[2]);
+				pos += size;
+
+				if (type == 0x1F) continue;  // Root folder like the computer
+				if ((type & 0x70) == 0x20) {  // Volume
+					path = ansi_at(item, 3);
+				} else if ((type & 0x70) == 0x30 && !path.empty()) {  // File entry
+					const auto name = file_entry_name(item);
+					if (name.empty()) return {};
+					path = join(std::move(path), name);
+				} else {
+					return {};  // Virtual folder or network location
+				}
+			}
+			return path;
+		}
+
+	}
+
+	// Target path stored in the data of a shortcut file, as it is stored without expanding environment
+	// variables (empty when it is not a shortcut or its target is not in the file system)
+	inline std::wstring parse(std::string_view d) {
+		uint32_t hs, flags;
+		if (!detail::u32(d, 0, hs) || hs != HEADER_SIZE || d.size() < HEADER_SIZE || d.substr(4, 16) != LINK_CLSID) return {};
+		if (!detail::u32(d, 0x14, flags)) return {};
+		size_t pos = HEADER_SIZE;
+
+		std::string_view ids, li;
+		if (flags & HAS_LINK_TARGET_ID_LIST) {
+			uint32_t size;
+			if (!detail::u16(d, pos, size) || size > d.size() - pos - 2) return {};
+			ids = d.substr(pos + 2, size);
+			pos += 2 + size;
+		}
+		if (flags & HAS_LINK_INFO) {
+			uint32_t size;
+			if (!detail::u32(d, pos, size) || size > d.size() - pos) return {};
+			if (!(flags & FORCE_NO_LINK_INFO)) li = d.substr(pos, size);
+			pos += size;
+		}
+		// Skip the string data
+		for (const auto f : { HAS_NAME, HAS_RELATIVE_PATH, HAS_WORKING_DIR, HAS_ARGUMENTS, HAS_ICON_LOCATION }) {
+			if (!(flags & f)) continue;
+			uint32_t count;
+			if (!detail::u16(d, pos, count)) return {};
+			pos += 2 + count * ((flags & IS_UNICODE) ? 2 : 1);
+		}
+		// The target with environment variables, which is the raw path of the shell
+		if (flags & HAS_EXP_STRING) {
+			uint32_t size, sig;
+			while (detail::u32(d, pos, size) && size >= 8 && size <= d.size() - pos) {
+				if (detail::u32(d, pos + 4, sig) && sig == ENVIRONMENT_VARIABLE_DATA_BLOCK && size >= 8 + 260 + 520) {
+					auto t = detail::unicode_at(d.substr(pos + 8 + 260, 520), 0);
+					if (t.empty()) t = detail::ansi_at(d.substr(pos + 8, 260), 0);
+					if (!t.empty()) return t;
+				}
+				pos += size;
+			}
+		}
+		if (!li.empty()) {
+			if (auto t = detail::link_info_path(li); !t.empty()) return t;
+		}
+		return ids.empty() ? std::wstring{} : detail::id_list_path(ids);
+	}
+
+	// Target path of the shortcut file, read from its mapping
+	inline std::wstring target(const std::wstring& path) {
+		MappedFile mf;
+		if (!mf.open(path)) return {};
+		return parse({ static_cast<const char*>(mf.data()), mf.size() });
+	}
+
+}
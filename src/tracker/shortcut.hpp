@@ -2,7 +2,7 @@
  * Shortcut File Operations
  *
  * @author Takuto Yanagida
- * @version 2025-11-13
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -10,14 +10,15 @@
 #include <string>
 #include <vector>
 
-#include <Shlobj.h>
-
+#include "os.hpp"
 #include "path.hpp"
 #include "file_system.hpp"
+#include "shell_link.hpp"
 
-namespace link {
+namespace shortcut {
 
-	IShellLink* get_shell_link_interface() noexcept {
+#ifdef _WIN32
+	inline IShellLink* get_shell_link_interface() noexcept {
 		LPVOID ptr = nullptr;
 		const auto hr = ::CoCreateInstance(CLSID_ShellLink, nullptr, CLSCTX_INPROC_SERVER, IID_IShellLink, &ptr);
 		if (FAILED(hr) || ptr == nullptr) {
@@ -26,7 +27,7 @@ namespace link {
 		return static_cast<IShellLink*>(ptr);
 	}
 
-	IPersistFile* get_persist_file_interface(IShellLink* psl) {
+	inline IPersistFile* get_persist_file_interface(IShellLink* psl) {
 		if (psl == nullptr) {
 			return nullptr;
 		}
@@ -37,14 +38,16 @@ namespace link {
 		}
 		return static_cast<IPersistFile*>(ptr);
 	}
+#endif
 
 	// Check whether the path is a shortcut file
-	bool is_link(const std::wstring& path) noexcept {
+	inline bool is_link(const std::wstring& path) noexcept {
 		return !file_system::is_directory(path) && path::ext(path) == L"lnk";
 	}
 
 	// Create shortcut file
-	bool create(const std::wstring& shortcut_path, const std::wstring& target) {
+	inline bool create(const std::wstring& shortcut_path, const std::wstring& target) {
+#ifdef _WIN32
 		IShellLink* psl = get_shell_link_interface();
 		if (psl == nullptr) return false;
 
@@ -63,11 +66,17 @@ namespace link {
 			psl->Release();
 			return false;
 		}
+#else
+		(void)shortcut_path;
+		(void)target;
+		return false;
+#endif
 	}
 
-	// Resolve shortcut and get the target path
-	std::wstring resolve(const std::wstring& path) {
+	// Resolve shortcut by the shell link object (only on Windows)
+	inline std::wstring resolve_by_shell(const std::wstring& path) {
 		std::wstring target;
+#ifdef _WIN32
 		IShellLink* psl = get_shell_link_interface();
 		if (psl == nullptr) return target;
 
@@ -85,6 +94,16 @@ namespace link {
 			ppf->Release();
 		}
 		psl->Release();
+#else
+		(void)path;
+#endif
+		return target;
+	}
+
+	// Resolve shortcut and get the target path; the file is read directly, and by the shell when it is not read
+	inline std::wstring resolve(const std::wstring& path) {
+		auto target = shell_link::target(path);
+		if (target.empty()) target = resolve_by_shell(path);
 		return target;
 	}
 
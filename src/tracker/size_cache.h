@@ -0,0 +1,67 @@
+/**
+ * Size Cache (Total Sizes of Folders Calculated Recently)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+#include "os.hpp"
+
+class SizeCache {
+
+	inline static const size_t   MAX_ENTRIES = 65536;
+	inline static const uint64_t MAX_AGE     = 60 * 1000;  // Age of the sizes to be used [ms]
+
+	// The time of a folder changes by its children but not by its descendants, so a size is also limited by its age
+	struct Entry {
+		uint64_t time;  // Last write time of the folder
+		uint64_t size;
+		uint64_t at;    // When calculated
+	};
+
+	mutable std::mutex mutex_;
+	std::unordered_map<std::wstring, Entry> es_;
+
+public:
+
+	SizeCache() noexcept = default;
+	SizeCache(const SizeCache&) = delete;
+	SizeCache& operator=(const SizeCache&) = delete;
+	SizeCache(SizeCache&&) = delete;
+	SizeCache& operator=(SizeCache&&) = delete;
+	~SizeCache() = default;
+
+	// Cache shared by the calculations of the sizes
+	static SizeCache& shared() {
+		static SizeCache c;
+		return c;
+	}
+
+	// Size of the folder calculated recently when the folder has not been changed since then
+	bool get(const std::wstring& path, uint64_t time, uint64_t& size) const {
+		std::lock_guard lock(mutex_);
+		const auto it = es_.find(path);
+		if (it == es_.end() || it->second.time != time || os::tick_count() - it->second.at > MAX_AGE) return false;
+		size = it->second.size;
+		return true;
+	}
+
+	void put(const std::wstring& path, uint64_t time, uint64_t size) {
+		std::lock_guard lock(mutex_);
+		if (es_.size() >= MAX_ENTRIES) es_.clear();
+		es_.insert_or_assign(path, Entry{ time, size, os::tick_count() });
+	}
+
+	void clear() {
+		std::lock_guard lock(mutex_);
+		es_.clear();
+	}
+
+};
@@ -0,0 +1,259 @@
+/**
+ * Size Calculator (Total Size of Files and Folders Walked in Parallel)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <stop_token>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+#include "os.hpp"
+#include "file_system.hpp"
+#include "path.hpp"
+#include "size_cache.h"
+#include "sort_engine.hpp"
+
+class SizeCalculator {
+
+	// Folder being walked; its total is added to the parent's when it and all its subfolders are done
+	struct Node {
+		Node* parent;
+		std::wstring path;
+		uint64_t time;
+		size_t index;  // Index of the folders given for those without the parent
+		std::atomic<uint64_t> total{};
+		std::atomic<uint32_t> pending{ 1 };  // Listing of itself and the subfolders not done
+
+		Node(Node* parent, std::wstring path, uint64_t time, size_t index) : parent(parent), path(std::move(path)), time(time), index(index) {}
+	};
+
+	// Folders to walk of a worker, who takes the last while the others steal the first
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Node*> nodes;
+	};
+
+	SizeCache& cache_;
+	std::mutex nodes_mutex_;
+	std::deque<Node> nodes_;
+	std::vector<std::unique_ptr<Queue>> qs_;
+
+	std::mutex mutex_;
+	std::condition_variable_any cv_;
+	std::atomic<size_t> queued_{};  // Folders in the queues
+	std::atomic<size_t> work_{};    // Folders queued or being walked
+	std::atomic<size_t> idle_{};
+	std::atomic<bool> stop_{};
+	std::atomic<uint64_t> counted_{};  // Sizes added so far
+	std::function<void(size_t, uint64_t)> done_;  // Called with each folder given when it is done
+
+	Node* make_node(Node* parent, std::wstring path, uint64_t time, size_t index = 0) {
+		std::lock_guard lock(nodes_mutex_);
+		return &nodes_.emplace_back(parent, std::move(path), time, index);
+	}
+
+	void push(size_t w, Node* n) {
+		++work_;
+		{
+			std::lock_guard lock(qs_[w]->mutex);
+			qs_[w]->nodes.push_back(n);
+		}
+		++queued_;
+		if (idle_ > 0) {
+			std::lock_guard lock(mutex_);
+			cv_.notify_all();
+		}
+	}
+
+	Node* pop(size_t w) {
+		for (size_t i = 0; i < qs_.size(); ++i) {
+			auto& q = *qs_[(w + i) % qs_.size()];
+			std::lock_guard lock(q.mutex);
+			if (q.nodes.empty()) continue;
+			Node* n;
+			if (i == 0) {
+				n = q.nodes.back();
+				q.nodes.pop_back();
+			} else {
+				n = q.nodes.front();
+				q.nodes.pop_front();
+			}
+			--queued_;
+			return n;
+		}
+		return nullptr;
+	}
+
+	// Drop a count of the folder, completing it and its parents whose counts become zero
+	void finish(Node* n) {
+		while (n && --n->pending == 0) {
+			const uint64_t total = n->total;
+			cache_.put(n->path, n->time, total);
+			if (!n->parent && done_) done_(n->index, total);
+			n = n->parent;
+			if (n) n->total += total;
+		}
+	}
+
+	// Add the sizes of the files in the folder and queue the subfolders whose sizes are not cached
+	void walk(size_t w, Node* n) {
+		uint64_t own = 0;
+		bool broken = false;
+		std::vector<Node*> subs;
+		file_system::find_first_file(n->path, [&](const std::wstring& parent, const os::FindData& fd) {
+			if (stop_) {
+				broken = true;
+				return false;
+			}
+			if (!(fd.attr & os::ATTR_DIRECTORY)) {
+				own += fd.size;
+				return true;
+			}
+			if (fd.attr & os::ATTR_REPARSE_POINT) return true;  // Not counted twice
+			std::wstring p{ parent };
+			p.append(fd.name);
+			uint64_t size{};
+			if (cache_.get(p, fd.time, size)) {
+				own += size;
+			} else {
+				++n->pending;
+				subs.push_back(make_node(n, std::move(p), fd.time));
+			}
+			return true;
+		});
+		counted_ += own;
+		if (broken) return;  // Neither it nor its parents are completed
+		n->total += own;
+		for (auto* s : subs) push(w, s);
+		finish(n);
+	}
+
+	void run(size_t w) {
+		os::fail_critical_errors_in_thread();
+		while (!stop_) {
+			if (Node* n = pop(w)) {
+				walk(w, n);
+				if (--work_ == 0) {
+					std::lock_guard lock(mutex_);
+					cv_.notify_all();
+				}
+				continue;
+			}
+			std::unique_lock lock(mutex_);
+			++idle_;
+			cv_.wait(lock, [&] { return queued_ > 0 || work_ == 0 || stop_; });
+			--idle_;
+			if (work_ == 0) return;
+		}
+	}
+
+	void reset(size_t threads) {
+		nodes_.clear();
+		qs_.clear();
+		for (size_t i = 0; i < (std::max)(threads, size_t{ 1 }); ++i) qs_.push_back(std::make_unique<Queue>());
+		queued_ = work_ = idle_ = 0;
+		stop_    = false;
+		counted_ = 0;
+	}
+
+	// Walk the folders by the workers until all are done, the time limit is over or it is stopped (the first
+	// folder is taken first)
+	bool walk_all(const std::vector<Node*>& roots, uint64_t limit_time, std::stop_token st) {
+		if (roots.empty()) return true;
+		for (size_t i = roots.size(); i-- > 0;) push(i % qs_.size(), roots[i]);
+
+		std::vector<std::jthread> ws;
+		for (size_t i = 0; i < qs_.size(); ++i) ws.emplace_back([this, i] { run(i); });
+		bool done;
+		{
+			std::unique_lock lock(mutex_);
+			const auto pred = [&] { return work_ == 0; };
+			if (limit_time == 0) {
+				done = cv_.wait(lock, st, pred);
+			} else {
+				const auto now = os::tick_count();
+				const auto wait = std::chrono::milliseconds((limit_time > now) ? limit_time - now : 0);
+				done = cv_.wait_for(lock, st, wait, pred);
+			}
+			if (!done) stop_ = true;
+			cv_.notify_all();
+		}
+		ws.clear();  // Joined
+		return done;
+	}
+
+public:
+
+	SizeCalculator(SizeCache& cache = SizeCache::shared()) noexcept : cache_(cache) {}
+	SizeCalculator(const SizeCalculator&) = delete;
+	SizeCalculator& operator=(const SizeCalculator&) = delete;
+	SizeCalculator(SizeCalculator&&) = delete;
+	SizeCalculator& operator=(SizeCalculator&&) = delete;
+	~SizeCalculator() = default;
+
+	// Size counted so far by the calculation running in another thread
+	uint64_t counted() const noexcept {
+		return counted_;
+	}
+
+	// Calculate the total size of the files and the folders by the time limit (tick count, or 0 for none);
+	// folders are walked by the workers stealing them from each other, and the sizes of the folders done are
+	// cached also when the limit is over or it is stopped (returns false then, with the size counted so far)
+	bool calc(const std::vector<std::wstring>& paths, uint64_t& size, uint64_t limit_time, size_t threads = sort_engine::thread_count(), std::stop_token st = {}) {
+		reset(threads);
+		size = 0;
+
+		std::vector<Node*> roots;
+		for (const auto& p : paths) {
+			uint64_t s{}, time{};
+			if (!file_system::is_directory(p)) {
+				if (!os::file_size(p, s)) return false;
+				size += s;
+			} else if (os::file_time(p, time) && cache_.get(p, time, s)) {
+				size += s;
+			} else {
+				roots.push_back(make_node(nullptr, p, time));
+			}
+		}
+		counted_ = size;
+		if (!walk_all(roots, limit_time, st)) {
+			size = counted_;
+			return false;
+		}
+		for (const auto* r : roots) size += r->total;
+		return true;
+	}
+
+	// Calculate the total size of each folder by the workers shared among the folders, calling fn from a
+	// worker with the index and the size of each folder when it is done (returns false when it is stopped)
+	bool calc_each(const std::vector<std::wstring>& dirs, std::function<void(size_t, uint64_t)> fn, size_t threads = sort_engine::thread_count(), std::stop_token st = {}) {
+		reset(threads);
+		std::vector<Node*> roots;
+		for (size_t i = 0; i < dirs.size(); ++i) {
+			uint64_t s{}, time{};
+			if (os::file_time(dirs[i], time) && cache_.get(dirs[i], time, s)) {
+				fn(i, s);
+			} else {
+				roots.push_back(make_node(nullptr, dirs[i], time, i));
+			}
+		}
+		done_ = std::move(fn);
+		const bool ret = walk_all(roots, 0, st);
+		done_ = nullptr;
+		return ret;
+	}
+
+};
@@ -0,0 +1,113 @@
+/**
+ * Sort Engine (Radix Sort and Parallel Merge Sort of Row Indices)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <vector>
+#include <array>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+
+namespace sort_engine {
+
+	// Below these sizes std::sort is faster (see bench/bench.cpp --crossover)
+	constexpr size_t RADIX_THRESHOLD    = 256;
+	constexpr size_t PARALLEL_THRESHOLD = 16384;
+
+	// Number of threads used for sorting
+	inline size_t thread_count() noexcept {
+		const size_t n = std::thread::hardware_concurrency();
+		return (n == 0) ? 1 : (n > 8 ? 8 : n);
+	}
+
+	struct KeyRow {
+		uint64_t key;
+		uint32_t row;
+	};
+
+	// Stable LSD radix sort of rows by 64-bit keys, skipping bytes that are the same in all keys
+	template<typename K> void radix_sort(std::vector<uint32_t>& rows, K key) {
+		const size_t n = rows.size();
+		std::vector<KeyRow> a(n), b(n);
+		std::array<std::array<size_t, 256>, 8> hist{};
+		for (size_t i = 0; i < n; ++i) {
+			const uint64_t k = key(rows[i]);
+			a[i] = { k, rows[i] };
+			for (size_t d = 0; d < 8; ++d) ++hist[d][(k >> (d * 8)) & 0xFF];
+		}
+		for (size_t d = 0; d < 8; ++d) {
+			auto& h = hist[d];
+			if (std::any_of(h.begin(), h.end(), [&](size_t c) { return c == n; })) continue;  // All the same
+			size_t sum = 0;
+			for (auto& c : h) {
+				const auto t = c;
+				c = sum;
+				sum += t;
+			}
+			for (const auto& kr : a) b[h[(kr.key >> (d * 8)) & 0xFF]++] = kr;
+			a.swap(b);
+		}
+		for (size_t i = 0; i < n; ++i) rows[i] = a[i].row;
+	}
+
+	// Sort rows by the radix keys of the comparator, then break ties in runs of equal keys by the comparator
+	template<typename C> void radix_sort_by(std::vector<uint32_t>& rows, const C& cmp) {
+		if (rows.size() < RADIX_THRESHOLD) {
+			std::sort(rows.begin(), rows.end(), cmp);
+			return;
+		}
+		radix_sort(rows, [&](uint32_t r) { return cmp.radix_key(r); });
+		for (size_t i = 0; i < rows.size();) {
+			const auto k = cmp.radix_key(rows[i]);
+			size_t e = i + 1;
+			while (e < rows.size() && cmp.radix_key(rows[e]) == k) ++e;
+			if (e - i > 1) std::sort(rows.begin() + i, rows.begin() + e, cmp);
+			i = e;
+		}
+	}
+
+	// Sort chunks on threads and merge them pairwise, also on threads
+	template<typename C> void parallel_sort(std::vector<uint32_t>& rows, const C& cmp, size_t threads = thread_count()) {
+		const size_t n = rows.size();
+		if (threads <= 1 || n < PARALLEL_THRESHOLD) {
+			std::sort(rows.begin(), rows.end(), cmp);
+			return;
+		}
+		std::vector<size_t> bounds;
+		for (size_t t = 0; t <= threads; ++t) bounds.push_back(n * t / threads);
+		{
+			std::vector<std::jthread> ws;
+			for (size_t t = 0; t < threads; ++t) {
+				ws.emplace_back([&, t]() { std::sort(rows.begin() + bounds[t], rows.begin() + bounds[t + 1], cmp); });
+			}
+		}
+		std::vector<uint32_t> buf(n);
+		while (bounds.size() > 2) {
+			std::vector<size_t> next;
+			{
+				std::vector<std::jthread> ws;
+				for (size_t i = 0; i + 2 < bounds.size(); i += 2) {
+					const auto b = bounds[i], m = bounds[i + 1], e = bounds[i + 2];
+					ws.emplace_back([&, b, m, e]() {
+						std::merge(rows.begin() + b, rows.begin() + m, rows.begin() + m, rows.begin() + e, buf.begin() + b, cmp);
+					});
+					next.push_back(b);
+				}
+				if (bounds.size() % 2 == 0) {  // An odd chunk is left as it is
+					const auto b = bounds[bounds.size() - 2], e = bounds.back();
+					std::copy(rows.begin() + b, rows.begin() + e, buf.begin() + b);
+					next.push_back(b);
+				}
+			}
+			next.push_back(n);
+			rows.swap(buf);
+			bounds.swap(next);
+		}
+	}
+
+};
@@ -0,0 +1,164 @@
+/**
+ * Subtree Searcher (Background Search of Files below a Folder)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <stop_token>
+#include <cstdint>
+
+#include "os.hpp"
+#include "file_system.hpp"
+#include "path.hpp"
+#include "matcher.h"
+#include "directory_lister.h"
+#include "sort_engine.hpp"
+
+class SubtreeSearcher {
+
+	inline static const uint64_t NOTIFY_INTERVAL = 100;  // Minimum interval of notifications [ms]
+
+	// Shared with the workers, which are left to end by themselves when canceled since they may be stuck in
+	// a folder not answering (files found by the searches canceled are ignored by the generation)
+	struct State {
+		std::mutex mutex;
+		std::condition_variable_any cv;
+		std::deque<std::wstring> dirs;  // Folders to walk, relative to the root and ending with a separator
+		size_t active{};                // Workers walking a folder
+		DirectoryLister::Batch pending;
+		bool done{ true };
+		bool posted{};
+		uint64_t last{};
+		uint64_t gen{};
+		std::function<void()> notify;
+	};
+
+	std::shared_ptr<State> st_{ std::make_shared<State>() };
+	std::stop_source stop_;
+
+	// Walk the folders taken from the queue, adding the subfolders to it, until all the folders are walked
+	static void run(const std::shared_ptr<State>& st, uint64_t gen, std::stop_token stop, const std::wstring& root, const Matcher& m) {
+		os::fail_critical_errors_in_thread();
+		DirectoryLister::Batch found;
+		std::vector<std::wstring> subs;
+		std::wstring name;
+
+		while (true) {
+			std::wstring rel;
+			{
+				std::unique_lock lock(st->mutex);
+				st->cv.wait(lock, stop, [&] { return !st->dirs.empty() || st->active == 0; });
+				if (stop.stop_requested() || st->gen != gen || st->dirs.empty()) return;
+				rel = std::move(st->dirs.front());
+				st->dirs.pop_front();
+				++st->active;
+			}
+			found.clear();
+			subs.clear();
+			file_system::find_first_file(root + rel, [&](const std::wstring&, const os::FindData& fd) {
+				if (stop.stop_requested()) return false;
+				name.assign(rel).append(fd.name);
+				if ((fd.attr & os::ATTR_DIRECTORY) && !(fd.attr & os::ATTR_REPARSE_POINT)) {
+					subs.push_back(name + path::PATH_SEPARATOR);
+				}
+				if (m.match(fd.name)) found.add({ name, fd.attr, fd.size, fd.time });
+				return true;  // continue
+			});
+
+			std::function<void()> notify;
+			{
+				std::lock_guard lock(st->mutex);
+				if (st->gen != gen) return;  // Canceled
+				for (auto& s : subs) st->dirs.push_back(std::move(s));
+				for (size_t i = 0; i < found.size(); ++i) st->pending.add(found.at(i));
+				--st->active;
+				if (st->dirs.empty() && st->active == 0) st->done = true;
+
+				const auto now = os::tick_count();
+				if (!st->posted && (st->done || (st->pending.size() && now - st->last >= NOTIFY_INTERVAL))) {
+					st->posted = true;
+					st->last   = now;
+					notify     = st->notify;
+				}
+			}
+			st->cv.notify_all();
+			if (notify) notify();
+		}
+	}
+
+public:
+
+	SubtreeSearcher() noexcept = default;
+	SubtreeSearcher(const SubtreeSearcher&) = delete;
+	SubtreeSearcher& operator=(const SubtreeSearcher&) = delete;
+	SubtreeSearcher(SubtreeSearcher&&) = delete;
+	SubtreeSearcher& operator=(SubtreeSearcher&&) = delete;
+
+	~SubtreeSearcher() {
+		cancel();
+		std::lock_guard lock(st_->mutex);
+		st_->notify = nullptr;
+	}
+
+	// Set the function called from a worker when found files are ready to be taken
+	void set_notifier(std::function<void()> fn) {
+		std::lock_guard lock(st_->mutex);
+		st_->notify = std::move(fn);
+	}
+
+	// Start searching the files below the folder whose names match the matchers made by setup
+	// (the previous search is canceled); names of the files found are relative to the folder
+	void start(const std::wstring& path, const std::function<void(Matcher&)>& setup, size_t threads = sort_engine::thread_count()) {
+		cancel();
+		std::wstring root{ path };
+		if (root.back() != path::PATH_SEPARATOR) root.append(1, path::PATH_SEPARATOR);
+		uint64_t gen;
+		{
+			std::lock_guard lock(st_->mutex);
+			st_->dirs.assign(1, std::wstring());
+			st_->active = 0;
+			st_->pending.clear();
+			st_->done   = false;
+			st_->posted = false;
+			st_->last   = os::tick_count();
+			gen = st_->gen;
+		}
+		stop_ = std::stop_source{};
+		for (size_t i = 0; i < threads; ++i) {
+			auto m = std::make_unique<Matcher>();  // One for each worker since matchers keep caches
+			setup(*m);
+			std::thread([st = st_, gen, stop = stop_.get_token(), root, m = std::move(m)] { run(st, gen, stop, root, *m); }).detach();
+		}
+	}
+
+	// Stop the current search without waiting for the workers and discard the files not taken
+	void cancel() {
+		stop_.request_stop();
+		std::lock_guard lock(st_->mutex);
+		++st_->gen;
+		st_->dirs.clear();
+		st_->pending.clear();
+		st_->done = true;
+	}
+
+	// Take the files found so far (returns true when the search is done)
+	bool take(DirectoryLister::Batch& out) {
+		out.clear();
+		std::lock_guard lock(st_->mutex);
+		std::swap(out, st_->pending);
+		st_->posted = false;
+		return st_->done;
+	}
+
+};
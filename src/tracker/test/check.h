@@ -0,0 +1,60 @@
+/**
+ * Checks Shared by the Tests
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+
+#include "os.hpp"
+
+namespace check {
+
+	inline int failures = 0;
+
+	inline void expect(bool ok, const char* what, const char* file, int line) {
+		if (ok) return;
+		if (++failures <= 20) std::fprintf(stderr, "%s:%d: failed: %s\n", file, line, what);
+	}
+
+	// Exit code of the test
+	inline int result() {
+		if (failures) std::fprintf(stderr, "%d failure(s)\n", failures);
+		return failures ? 1 : 0;
+	}
+
+	// Whether the rows are the same regardless of their order
+	inline bool same_rows(std::vector<uint32_t> a, std::vector<uint32_t> b) {
+		std::sort(a.begin(), a.end());
+		std::sort(b.begin(), b.end());
+		return a == b;
+	}
+
+	// Empty folder for the files of a test, removed by the next run
+	inline std::filesystem::path temp_dir(const char* name) {
+		auto dir = std::filesystem::temp_directory_path() / "tracker_test" / name;
+		std::error_code ec;
+		std::filesystem::remove_all(dir, ec);
+		std::filesystem::create_directories(dir);
+		return dir;
+	}
+
+	inline std::wstring wide(const std::filesystem::path& p) {
+#ifdef _WIN32
+		return p.wstring();
+#else
+		return os::from_utf8(p.string());
+#endif
+	}
+
+}
+
+#define CHECK(cond) check::expect((cond), #cond, __FILE__, __LINE__)
@@ -0,0 +1,62 @@
+/**
+ * Test of the Natural-Order Collator and its Sort Keys
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "collator.hpp"
+
+namespace {
+
+	int sign(int v) noexcept {
+		return (v > 0) - (v < 0);
+	}
+
+	int compare_by_keys(std::wstring_view s1, std::wstring_view s2) {
+		std::vector<uint32_t> k1, k2;
+		collator::append_key(k1, s1);
+		collator::append_key(k2, s2);
+		return collator::compare_key(k1.data(), k2.data());
+	}
+
+	void test_order() {
+		CHECK(collator::compare(L"a2", L"a10") < 0);
+		CHECK(collator::compare(L"a10", L"a2") > 0);
+		CHECK(collator::compare(L"File", L"file") == 0);
+		CHECK(collator::compare(L"1", L"a") < 0);
+		CHECK(collator::compare(L"a", L"ab") < 0);
+		CHECK(collator::compare(L"x２", L"x10") < 0);  // Full-width digits
+		CHECK(compare_by_keys(L"a2", L"a10") < 0);
+		CHECK(compare_by_keys(L"x２", L"x10") < 0);
+	}
+
+	// Keys are in the same order as the strings
+	void test_keys() {
+		std::mt19937 rng(7);
+		const std::wstring chars = L"aAbZ_.- 0012０１あ";
+		const auto make = [&] {
+			std::wstring s;
+			const auto n = rng() % 10;
+			for (size_t i = 0; i < n; ++i) s += chars[rng() % chars.size()];
+			return s;
+		};
+		for (int t = 0; t < 20000; ++t) {
+			const auto s1 = make(), s2 = make();
+			CHECK(sign(collator::compare(s1, s2)) == sign(compare_by_keys(s1, s2)));
+			CHECK(sign(collator::compare(s1, s2)) == -sign(collator::compare(s2, s1)));
+		}
+	}
+
+}
+
+int main() {
+	test_order();
+	test_keys();
+	return check::result();
+}
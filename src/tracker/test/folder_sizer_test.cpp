@@ -0,0 +1,123 @@
+/**
+ * Test of the Folder Sizer Notifying the Sizes Calculated
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "check.h"
+#include "folder_sizer.h"
+
+namespace {
+
+	namespace fs = std::filesystem;
+
+	// Folders of the rows, walked in all for longer than the interval of notifications
+	std::vector<std::pair<uint32_t, std::wstring>> make_dirs(const fs::path& root, int subs) {
+		std::vector<std::pair<uint32_t, std::wstring>> dirs;
+		for (int d = 0; d < 40; ++d) {
+			const auto dir = root / ("folder" + std::to_string(d));
+			fs::create_directories(dir);
+			for (int s = 0; s < subs; ++s) fs::create_directories(dir / ("sub" + std::to_string(s)));
+			for (int f = 0; f < 20; ++f) {
+				const auto parent = dir / ("sub" + std::to_string(f % subs));
+				std::ofstream(parent / ("file" + std::to_string(f) + ".bin"), std::ios::binary) << std::string(static_cast<size_t>(d * 10 + f), 'x');
+			}
+			dirs.emplace_back(static_cast<uint32_t>(100 + d), check::wide(dir));
+		}
+		return dirs;
+	}
+
+	uint64_t walk(const fs::path& dir) {
+		uint64_t size = 0;
+		for (const auto& e : fs::recursive_directory_iterator(dir)) {
+			if (e.is_regular_file()) size += e.file_size();
+		}
+		return size;
+	}
+
+	// Sizes are taken only when notified, as the window does, until all are taken or no notification comes
+	class Receiver {
+
+		std::mutex mutex_;
+		std::condition_variable cv_;
+		int notified_{};
+		int seen_{};
+
+	public:
+
+		void notify() {
+			std::lock_guard lock(mutex_);
+			++notified_;
+			cv_.notify_all();
+		}
+
+		std::map<uint32_t, uint64_t> receive(FolderSizer& sizer, size_t count) {
+			std::map<uint32_t, uint64_t> ret;
+			FolderSizer::Sizes sizes;
+			while (ret.size() < count) {
+				{
+					std::unique_lock lock(mutex_);
+					if (!cv_.wait_for(lock, std::chrono::seconds(2), [&] { return notified_ > seen_; })) break;
+					seen_ = notified_;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(20));  // Folders are done while the notification is outstanding
+				sizer.take(sizes);
+				for (const auto& [row, size] : sizes) ret[row] = size;
+			}
+			return ret;
+		}
+
+	};
+
+	// The sizes of all the folders are notified, including the last ones done soon after a notification
+	void test_notify(const fs::path& root) {
+		const auto dirs = make_dirs(root / "notify", 500);
+		Receiver r;
+		FolderSizer sizer;
+		sizer.set_notifier([&] { r.notify(); });
+		sizer.start(dirs);
+		const auto sizes = r.receive(sizer, dirs.size());
+		CHECK(sizes.size() == dirs.size());
+		for (const auto& [row, path] : dirs) {
+			const auto it = sizes.find(row);
+			CHECK(it != sizes.end() && it->second == walk(path));
+		}
+	}
+
+	// Sizes of a calculation canceled are not taken
+	void test_cancel(const fs::path& root) {
+		const auto dirs = make_dirs(root / "cancel", 10);
+		Receiver r;
+		FolderSizer sizer;
+		sizer.set_notifier([&] { r.notify(); });
+		FolderSizer::Sizes sizes;
+		for (int t = 0; t < 10; ++t) {
+			sizer.start(dirs);
+			sizer.cancel();
+			sizer.take(sizes);
+			CHECK(sizes.empty());
+		}
+		sizer.start({ dirs.front() });
+		CHECK(r.receive(sizer, 1).size() == 1);
+	}
+
+}
+
+int main() {
+	const auto root = check::temp_dir("folder_sizer");
+	test_notify(root);
+	test_cancel(root);
+	return check::result();
+}
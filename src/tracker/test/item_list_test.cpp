@@ -0,0 +1,170 @@
+/**
+ * Test of Sorting Again, Filtering, Ranking and Placing Sizes of the Item List
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "check.h"
+#include "type_table.h"
+#include "item_list.h"
+
+namespace {
+
+	void fill(ItemList& il, size_t n, const TypeTable& exts) {
+		std::mt19937_64 rng(11);
+		DirectorySnapshot snap;
+		snap.set_parent(L"/test/");
+		for (size_t i = 0; i < n; ++i) {
+			const auto r = rng();
+			const bool dir = r % 4 == 0;
+			const std::wstring name = (dir ? L"dir" : L"file") + std::to_wstring(r % 1000) + (dir ? L"" : L".txt");
+			snap.add_file(os::FindData{ name, dir ? os::ATTR_DIRECTORY : 0, dir ? 0 : (r >> 16) % 100, os::EPOCH_DIFF_TICKS + (r >> 40) % 50 }, exts);
+		}
+		il.assign(std::move(snap));
+	}
+
+	std::vector<uint32_t> rows_of(const ItemList& il) {
+		std::vector<uint32_t> rs;
+		for (size_t i = 0; i < il.size(); ++i) rs.push_back(static_cast<uint32_t>(il.at(i).row()));
+		return rs;
+	}
+
+	// Rows in an order equivalent to the rows sorted from scratch
+	template<typename C> bool sorted_as(const ItemList& il, const std::vector<uint32_t>& rows, const C& cmp) {
+		auto ref = rows;
+		std::stable_sort(ref.begin(), ref.end(), cmp);
+		const auto rs = rows_of(il);
+		if (!check::same_rows(rs, ref)) return false;
+		for (size_t i = 0; i < rs.size(); ++i) {
+			if (cmp(rs[i], ref[i]) || cmp(ref[i], rs[i])) return false;
+		}
+		return true;
+	}
+
+	// Sorting again by another key or only in the other direction gives the order of a sort from scratch
+	void test_resort(const TypeTable& exts) {
+		ItemList il;
+		fill(il, 1000, exts);
+		std::vector<uint32_t> all(il.size());
+		std::iota(all.begin(), all.end(), uint32_t{ 0 });
+		const auto& snap = il.snapshot();
+
+		il.sort(0, false);
+		CHECK(sorted_as(il, all, CompByName(snap, false)));
+		il.sort(0, true);
+		CHECK(sorted_as(il, all, CompByName(snap, true)));
+		il.sort(2, true);
+		CHECK(sorted_as(il, all, CompByDate(snap, true)));
+		il.sort(2, false);
+		CHECK(sorted_as(il, all, CompByDate(snap, false)));
+		il.sort(3, false);
+		CHECK(sorted_as(il, all, CompBySize(snap, false)));
+		il.sort(1, true);
+		CHECK(sorted_as(il, all, CompByType(snap, true)));
+		il.sort(1, true);
+		CHECK(sorted_as(il, all, CompByType(snap, true)));
+	}
+
+	// Narrowing keeps the rows matched in the current order, and widening brings the others back
+	void test_filter(const TypeTable& exts) {
+		ItemList il;
+		fill(il, 500, exts);
+		il.sort(0, false);
+		const auto all = rows_of(il);
+		const auto expect = [&](const std::wstring& word) {
+			std::vector<uint32_t> rs;
+			for (const auto r : all) {
+				if (Item{ &il.snapshot(), r, false }.name().find(word) != std::wstring_view::npos) rs.push_back(r);
+			}
+			return rs;
+		};
+		const auto by = [](std::wstring word) {
+			return [word](const Item& it) { return it.name().find(word) != std::wstring_view::npos; };
+		};
+		il.filter(by(L"1"), false);
+		CHECK(il.is_filtered());
+		CHECK(rows_of(il) == expect(L"1"));
+		il.filter(by(L"12"), true);
+		CHECK(rows_of(il) == expect(L"12"));
+		il.filter(by(L"2"), false);
+		CHECK(rows_of(il) == expect(L"2"));
+		il.unfilter();
+		CHECK(!il.is_filtered());
+		CHECK(check::same_rows(rows_of(il), all));
+	}
+
+	// Ranking shows the rows scored above zero, the higher scores first and in the current order for ties
+	void test_rank(const TypeTable& exts) {
+		ItemList il;
+		fill(il, 500, exts);
+		il.sort(0, false);
+		const auto all = rows_of(il);
+		const auto score = [&](uint32_t row) {
+			const auto name = Item{ &il.snapshot(), row, false }.name();
+			return name.starts_with(L"dir") ? 2 : name.ends_with(L"5.txt") ? 1 : 0;
+		};
+		std::vector<uint32_t> expect;
+		for (const auto r : all) {
+			if (score(r) > 0) expect.push_back(r);
+		}
+		std::stable_sort(expect.begin(), expect.end(), [&](uint32_t a, uint32_t b) { return score(a) > score(b); });
+
+		il.rank([&](const Item& it) { return score(static_cast<uint32_t>(it.row())); }, false);
+		CHECK(il.is_filtered());
+		CHECK(rows_of(il) == expect);
+		il.unfilter();
+		CHECK(check::same_rows(rows_of(il), all));
+	}
+
+	std::vector<std::pair<uint32_t, uint64_t>> random_sizes(std::mt19937& rng, size_t n, size_t k) {
+		std::vector<std::pair<uint32_t, uint64_t>> ss;
+		for (size_t i = 0; i < k; ++i) ss.emplace_back(static_cast<uint32_t>(rng() % n), rng() % 200);
+		return ss;
+	}
+
+	// Sizes set later are placed as if all the rows were sorted again, also while filtered
+	void test_set_sizes(const TypeTable& exts) {
+		std::mt19937 rng(13);
+		for (const size_t n : { size_t{ 10 }, size_t{ 1000 } }) {
+			for (const size_t k : { size_t{ 1 }, size_t{ 5 }, n / 2 }) {
+				for (const bool rev : { false, true }) {
+					ItemList il;
+					fill(il, n, exts);
+					il.sort(3, rev);
+					il.set_sizes(random_sizes(rng, n, k));
+					std::vector<uint32_t> all(n);
+					std::iota(all.begin(), all.end(), uint32_t{ 0 });
+					CHECK(sorted_as(il, all, CompBySize(il.snapshot(), rev)));
+
+					il.filter([](const Item& it) { return it.name().starts_with(L"file1"); }, false);
+					il.set_sizes(random_sizes(rng, n, k));
+					std::vector<uint32_t> shown;
+					for (const auto r : all) {
+						if (Item{ &il.snapshot(), r, false }.name().starts_with(L"file1")) shown.push_back(r);
+					}
+					CHECK(sorted_as(il, shown, CompBySize(il.snapshot(), rev)));
+					il.unfilter();
+					CHECK(sorted_as(il, all, CompBySize(il.snapshot(), rev)));
+				}
+			}
+		}
+	}
+
+}
+
+int main() {
+	const TypeTable exts;
+	test_resort(exts);
+	test_filter(exts);
+	test_rank(exts);
+	test_set_sizes(exts);
+	return check::result();
+}
@@ -0,0 +1,116 @@
+/**
+ * Test of the Link Resolver Resolving Shortcut Files in the Background
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+#include "link_resolver.h"
+#include "shell_link.hpp"
+
+namespace {
+
+	namespace fs = std::filesystem;
+
+	std::string u32(uint32_t v) {
+		return { static_cast<char>(v & 0xFF), static_cast<char>((v >> 8) & 0xFF), static_cast<char>((v >> 16) & 0xFF), static_cast<char>(v >> 24) };
+	}
+
+	// Shortcut whose target is the local path of the base and the suffix
+	std::string link(std::string_view base, std::string_view suffix) {
+		using namespace shell_link;
+		std::string h = u32(HEADER_SIZE) + std::string{ LINK_CLSID } + u32(HAS_LINK_INFO) + u32(0x20);
+		h.resize(HEADER_SIZE, '\0');
+		const uint32_t hs = 0x1C;
+		const std::string vol_id = u32(0x11) + u32(3) + u32(0) + u32(0x10) + '\0';
+		const auto b = std::string{ base } + '\0', s = std::string{ suffix } + '\0';
+		const uint32_t o_lbp = hs + static_cast<uint32_t>(vol_id.size()), o_cps = o_lbp + static_cast<uint32_t>(b.size());
+		const std::string body = u32(hs) + u32(1) + u32(hs) + u32(o_lbp) + u32(0) + u32(o_cps) + vol_id + b + s;
+		return h + u32(static_cast<uint32_t>(body.size()) + 4) + body + u32(0);
+	}
+
+	// Requests of the shortcuts, whose targets are 'C:\dir\app<row>.exe'
+	std::vector<LinkResolver::Request> make_links(const fs::path& dir, int count) {
+		fs::create_directories(dir);
+		std::vector<LinkResolver::Request> reqs;
+		for (int i = 0; i < count; ++i) {
+			const auto path = dir / ("link" + std::to_string(i) + ".lnk");
+			std::ofstream(path, std::ios::binary) << link("C:\\dir\\", "app" + std::to_string(i) + ".exe");
+			reqs.push_back({ static_cast<uint32_t>(i), check::wide(path), 0 });
+		}
+		return reqs;
+	}
+
+	std::wstring target_of(uint32_t row) {
+		return L"C:\\dir\\app" + std::to_wstring(row) + L".exe";
+	}
+
+	// Targets taken until all are taken or they are not taken for a while
+	std::map<uint32_t, std::wstring> take_all(LinkResolver& lr, size_t count) {
+		std::map<uint32_t, std::wstring> ret;
+		LinkResolver::Targets ts;
+		for (int wait = 0; ret.size() < count && wait < 2000; ++wait) {
+			lr.take(ts);
+			for (auto& [row, t] : ts) ret[row] = std::move(t);
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return ret;
+	}
+
+	// All the links are resolved and notified, and then found in the cache
+	void test_resolve(const fs::path& root) {
+		auto reqs = make_links(root / "resolve", 50);
+		std::atomic<int> notified{};
+		LinkResolver lr;
+		lr.set_notifier([&] { ++notified; });
+		lr.request(reqs);
+		const auto ts = take_all(lr, reqs.size());
+		CHECK(ts.size() == reqs.size());
+		for (const auto& [row, t] : ts) CHECK(t == target_of(row));
+		CHECK(notified > 0);
+
+		std::wstring target;
+		for (const auto& r : reqs) {
+			uint64_t time{};
+			CHECK(os::file_time(r.path, time));
+			CHECK(lr.cached(r.path, time, target) && target == target_of(r.row));
+		}
+	}
+
+	// Targets of the requests canceled are not taken, and the resolver ends without waiting for the worker
+	void test_cancel(const fs::path& root) {
+		const auto reqs = make_links(root / "cancel", 200);
+		LinkResolver::Targets ts;
+		for (int i = 0; i < 10; ++i) {
+			LinkResolver lr;
+			lr.request(reqs);
+			if (i % 2) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			lr.cancel();
+			lr.take(ts);
+			CHECK(ts.empty());
+			lr.request({ reqs.front() });
+			const auto one = take_all(lr, 1);
+			CHECK(one.size() == 1 && one.begin()->second == target_of(0));
+			lr.request(reqs);
+		}
+	}
+
+}
+
+int main() {
+	const auto root = check::temp_dir("link_resolver");
+	test_resolve(root);
+	test_cancel(root);
+	return check::result();
+}
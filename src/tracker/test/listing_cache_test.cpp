@@ -0,0 +1,98 @@
+/**
+ * Test of the Listing Cache Invalidated by Changes of the Folders
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "check.h"
+#include "type_table.h"
+#include "listing_cache.h"
+
+namespace {
+
+	namespace fs = std::filesystem;
+
+	DirectorySnapshot listing(const std::wstring& path, size_t n, const TypeTable& exts) {
+		DirectorySnapshot snap;
+		snap.set_parent(path);
+		for (size_t i = 0; i < n; ++i) {
+			snap.add_file(os::FindData{ L"file" + std::to_wstring(i) + L".txt", 0, i, os::EPOCH_DIFF_TICKS }, exts);
+		}
+		return snap;
+	}
+
+	// Listings are taken out once, and only with the flags they were made with
+	void test_take(const fs::path& dir, const TypeTable& exts) {
+		const auto a = check::wide(dir / "a");
+		fs::create_directories(dir / "a");
+		ListingCache lc;
+		lc.watch(a);
+		lc.put(a, 1, listing(a, 10, exts));
+		CHECK(lc.size() == 1);
+		const auto snap = lc.take(a, 1);
+		CHECK(snap && snap->size() == 10);
+		CHECK(!lc.take(a, 1));
+
+		lc.put(a, 1, listing(a, 10, exts));
+		CHECK(!lc.take(a, 2));
+		CHECK(lc.size() == 0);
+
+		const auto b = check::wide(dir / "b");  // Not watched, so that its changes would be missed
+		lc.put(b, 1, listing(b, 10, exts));
+		CHECK(!lc.take(b, 1));
+	}
+
+	// Listings of the folders changed after they were put are dropped, and the others are kept
+	void test_invalidate(const fs::path& dir, const TypeTable& exts) {
+		const auto a = check::wide(dir / "a"), b = check::wide(dir / "b");
+		fs::create_directories(dir / "a");
+		fs::create_directories(dir / "b");
+		ListingCache lc;
+		lc.watch(a);
+		lc.watch(b);
+		lc.put(a, 0, listing(a, 10, exts));
+		lc.put(b, 0, listing(b, 10, exts));
+		std::ofstream(dir / "a" / "added.txt") << "a";
+		CHECK(!lc.take(a, 0));
+		CHECK(lc.take(b, 0).has_value());
+
+		lc.put(b, 0, listing(b, 10, exts));  // Still watched as it was taken out to be shown
+		fs::remove(dir / "b");  // The folder itself is removed
+		CHECK(!lc.take(b, 0));
+		CHECK(lc.size() == 0);
+	}
+
+	// The least recently used listings are dropped over the limit, and the memory of the largest is reused
+	void test_evict(const fs::path& dir, const TypeTable& exts) {
+		ListingCache lc;
+		std::wstring first;
+		for (int i = 0; i < 20; ++i) {
+			const auto p = dir / ("folder" + std::to_string(i));
+			fs::create_directories(p);
+			const auto path = check::wide(p);
+			if (i == 0) first = path;
+			lc.watch(path);
+			lc.put(path, 0, listing(path, 100 + i, exts));
+		}
+		CHECK(lc.size() == 16);
+		CHECK(!lc.take(first, 0));
+		const auto spare = lc.take_spare();
+		CHECK(spare.size() == 0);
+		CHECK(spare.footprint() > 0);
+	}
+
+}
+
+int main() {
+	const TypeTable exts;
+	const auto dir = check::temp_dir("listing_cache");
+	test_take(dir, exts);
+	test_invalidate(dir, exts);
+	test_evict(dir, exts);
+	return check::result();
+}
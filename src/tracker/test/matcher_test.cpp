@@ -0,0 +1,114 @@
+/**
+ * Test of the Matcher against std::wregex
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <random>
+#include <regex>
+#include <string>
+
+#include "check.h"
+#include "matcher.h"
+
+namespace {
+
+	std::mt19937 rng(1);
+
+	// Random pattern in the syntax run by the automata
+	std::wstring pattern(int depth) {
+		std::wstring s;
+		const int n = 1 + static_cast<int>(rng() % 3);
+		for (int i = 0; i < n; ++i) {
+			switch (rng() % 9) {
+			case 0: case 1: case 2: case 3: s += L"abAB"[rng() % 4]; break;
+			case 4:
+				if (depth < 3) {
+					s += L"(" + pattern(depth + 1) + L"|" + pattern(depth + 1) + L")";
+				} else {
+					s += L"c";
+				}
+				break;
+			case 5: s += L"[a-b]"; break;
+			case 6: s += L"[^a]"; break;
+			case 7: s += L"."; break;
+			default: s += L"\\d"; break;
+			}
+			switch (rng() % 9) {
+			case 0: s += L"*"; break;
+			case 1: s += L"+"; break;
+			case 2: s += L"?"; break;
+			case 3: s += L"{2}"; break;
+			case 4: s += L"{0,2}"; break;
+			case 5: s += L"{1,}"; break;
+			default: break;
+			}
+		}
+		return s;
+	}
+
+	std::wstring subject() {
+		std::wstring s;
+		const int n = static_cast<int>(rng() % 8);
+		for (int i = 0; i < n; ++i) s += L"aAbB1c"[rng() % 6];
+		return s;
+	}
+
+	// Patterns like those of Migemo, which are run as sets of words
+	void test_words() {
+		Matcher m;
+		CHECK(m.set_pattern(L"(gakkou|がっこう|学校|ガッコウ)"));
+		CHECK(m.is_words());
+		CHECK(m.match(L"私立学校.txt"));
+		CHECK(m.match(L"GAKKOU"));
+		CHECK(!m.match(L"gakko"));
+
+		CHECK(m.set_pattern(L"ka[いきく]|カ"));
+		CHECK(m.match(L"kaき"));
+		CHECK(!m.match(L"kaけ"));
+	}
+
+	void test_literal() {
+		Matcher m;
+		m.set_literal(L"ReP");
+		CHECK(m.match(L"report.txt"));
+		CHECK(m.match(L"graph_REP.png"));
+		CHECK(!m.match(L"re.p"));
+		m.set_literal(L"");
+		CHECK(m.match(L"anything"));
+	}
+
+	// The same names are matched as by std::wregex
+	void test_differential() {
+		for (int t = 0; t < 1500; ++t) {
+			const auto p = pattern(0);
+			Matcher m;
+			if (!m.set_pattern(p)) {
+				CHECK(!"pattern rejected");
+				continue;
+			}
+			const std::wregex re(p, std::regex_constants::ECMAScript | std::regex_constants::icase);
+			for (int k = 0; k < 30; ++k) {
+				const auto s = subject();
+				CHECK(m.match(s) == std::regex_search(s, re));
+			}
+		}
+	}
+
+	void test_invalid() {
+		Matcher m;
+		CHECK(!m.set_pattern(L"(ab"));
+		CHECK(!m.set_pattern(L"[b-a]"));
+		CHECK(!m.set_pattern(std::wstring(2048, L'(')));
+	}
+
+}
+
+int main() {
+	test_words();
+	test_literal();
+	test_differential();
+	test_invalid();
+	return check::result();
+}
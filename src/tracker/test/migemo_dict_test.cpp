@@ -0,0 +1,129 @@
+/**
+ * Test of the Migemo Dictionary Compiled, Mapped Again and Broken
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "migemo_dict.h"
+
+namespace {
+
+	namespace fs = std::filesystem;
+
+	// Lines of readings and words in CP932
+	const char TEXT[] =
+		";comment\r\n"
+		"\x82\xA9\x82\xAB\t\x8A`\t\x89\xB2\x8A" "a\r\n"  // Kaki
+		"\x82\xA9\x82\xAD\t\x8F\x91\x82\xAD\r\n"         // Kaku
+		"\x82\xA9\t\x89\xE1\r\n"                         // Ka
+		"\x82\xB3\t\x8D\xB7\r\n";                        // Sa
+
+	std::set<std::wstring> words(const MigemoDict& d, std::wstring_view prefix) {
+		std::set<std::wstring> ret;
+		d.prefix_query(prefix, [&](std::wstring_view w) { ret.emplace(w); });
+		return ret;
+	}
+
+	bool readable(const MigemoDict& d) {
+		return words(d, L"か") == std::set<std::wstring>{ L"柿", L"牡蛎", L"書く", L"蚊" } &&
+			words(d, L"かき") == std::set<std::wstring>{ L"柿", L"牡蛎" } &&
+			words(d, L"さ") == std::set<std::wstring>{ L"差" } &&
+			words(d, L"た").empty() && words(d, L"かきく").empty();
+	}
+
+	std::string read(const fs::path& p) {
+		std::ifstream ifs(p, std::ios::binary);
+		return { std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>() };
+	}
+
+	void write(const fs::path& p, std::string_view bytes) {
+		std::ofstream(p, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	}
+
+	// The text is compiled at first, and the image written to the cache then is mapped next time; nothing is
+	// written next to the text
+	void test_round_trip(const fs::path& text, const fs::path& cache) {
+		{
+			MigemoDict d;
+			CHECK(d.load(check::wide(text)));
+			CHECK(!d.is_mapped());
+			CHECK(readable(d));
+		}
+		CHECK(!fs::exists(fs::path{ MigemoDict::image_path(check::wide(text)) }));
+		{
+			MigemoDict d;
+			CHECK(d.load(check::wide(text), check::wide(cache)));
+			CHECK(!d.is_mapped());
+			CHECK(readable(d));
+		}
+		MigemoDict d;
+		CHECK(d.load(check::wide(text), check::wide(cache)));
+		CHECK(d.is_mapped());
+		CHECK(readable(d));
+	}
+
+	// The image made beforehand next to the text is preferred to the cache
+	void test_prebuilt(const fs::path& text, const fs::path& cache) {
+		std::vector<uint32_t> image;
+		CHECK(MigemoDict::compile(check::wide(text), image));
+		const auto img = MigemoDict::image_path(check::wide(text));
+		CHECK(MigemoDict::save(img, image));
+		fs::remove(cache);
+		{
+			MigemoDict d;
+			CHECK(d.load(check::wide(text), check::wide(cache)));
+			CHECK(d.is_mapped());
+			CHECK(readable(d));
+		}
+		CHECK(!fs::exists(cache));
+		fs::remove(fs::path{ img });
+	}
+
+	// Broken images are not used but compiled again from the text, and images with bytes changed are used
+	// only when they stay in their ranges
+	void test_broken(const fs::path& text, const fs::path& cache) {
+		{
+			MigemoDict d;
+			CHECK(d.load(check::wide(text), check::wide(cache)));
+		}
+		const auto bytes = read(cache);
+		CHECK(!bytes.empty());
+		for (size_t n = 0; n < bytes.size(); ++n) {
+			write(cache, std::string_view{ bytes }.substr(0, n));
+			MigemoDict d;
+			CHECK(d.load(check::wide(text), check::wide(cache)));
+			CHECK(!d.is_mapped());
+			CHECK(readable(d));
+		}
+		for (size_t i = 0; i < bytes.size(); ++i) {
+			for (const char x : { '\x01', '\x80', '\xFF' }) {
+				auto b = bytes;
+				b[i] = static_cast<char>(b[i] ^ x);
+				write(cache, b);
+				MigemoDict d;
+				CHECK(d.load(check::wide(text), check::wide(cache)));
+				for (const auto* p : { L"", L"か", L"かき", L"かく", L"さ", L"た" }) words(d, p);
+			}
+		}
+	}
+
+}
+
+int main() {
+	const auto dir  = check::temp_dir("migemo_dict");
+	const auto text = dir / "migemo-dict";
+	const auto cache = dir / "cache.img";
+	write(text, TEXT);
+	test_round_trip(text, cache);
+	test_prebuilt(text, cache);
+	test_broken(text, cache);
+	return check::result();
+}
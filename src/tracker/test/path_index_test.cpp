@@ -0,0 +1,215 @@
+/**
+ * Test of the Path Index Built, Saved, Mapped Again and Broken
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+#include "matcher.h"
+#include "path_index.h"
+
+namespace {
+
+	namespace fs = std::filesystem;
+
+	void wait(const PathIndex& idx) {
+		while (idx.is_building()) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	std::set<std::wstring> query(const PathIndex& idx, const std::wstring& word) {
+		Matcher m;
+		m.set_literal(word);
+		std::set<std::wstring> ret;
+		idx.query(m.literal(), [&](std::wstring_view s) { return m.match(s); }, SIZE_MAX, [&](const os::FindData& fd) {
+			ret.emplace(fd.name);
+		});
+		return ret;
+	}
+
+	// Paths below the root whose names contain the word, found by walking the folders
+	std::set<std::wstring> walk(const fs::path& root, const std::wstring& word) {
+		Matcher m;
+		m.set_literal(word);
+		std::set<std::wstring> ret;
+		for (const auto& e : fs::recursive_directory_iterator(root)) {
+			if (m.match(check::wide(e.path().filename()))) ret.insert(check::wide(e.path()));
+		}
+		return ret;
+	}
+
+	void make_tree(const fs::path& root) {
+		for (int d = 0; d < 20; ++d) {
+			const auto dir = root / ("folder" + std::to_string(d)) / ("sub" + std::to_string(d % 3));
+			fs::create_directories(dir);
+			for (int f = 0; f < 30; ++f) {
+				std::ofstream(dir / ("report_" + std::to_string(d * 100 + f) + ".txt")) << f;
+			}
+		}
+	}
+
+	const std::vector<std::wstring> words = { L"rep", L"report_1", L"sub1", L"folder", L"txt", L"7.t", L"none" };
+
+	// Paths found in the background, taken until the search is done
+	std::set<std::wstring> search(PathIndex& idx, const std::function<void(Matcher&)>& setup, size_t max) {
+		std::set<std::wstring> ret;
+		DirectoryLister::Batch batch;
+		idx.search(setup, max);
+		for (bool done = false; !done; ) {
+			done = idx.take(batch);
+			for (size_t i = 0; i < batch.size(); ++i) ret.emplace(batch.at(i).name);
+			if (!done) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return ret;
+	}
+
+	bool same_as_walk(const PathIndex& idx, const fs::path& root) {
+		for (const auto& w : words) {
+			if (query(idx, w) != walk(root, w)) return false;
+		}
+		return true;
+	}
+
+	// The index finds the same paths as walking the folders
+	void test_build(const fs::path& dir) {
+		const auto root = dir / "root";
+		make_tree(root);
+		PathIndex idx;
+		idx.start(check::wide(dir / "index.dat"), { check::wide(root) });
+		wait(idx);
+		CHECK(idx.size() == 1 + 20 + 20 + 20 * 30);
+		CHECK(same_as_walk(idx, root));
+		idx.cancel();
+	}
+
+	// The index saved is mapped again for the next start, keeping the same names
+	void test_round_trip(const fs::path& dir) {
+		const auto root = dir / "root";
+		CHECK(fs::file_size(dir / "index.dat") > 0);
+		PathIndex idx;  // Folders not changed are taken from the index mapped
+		idx.start(check::wide(dir / "index.dat"), { check::wide(root) });
+		wait(idx);
+		CHECK(same_as_walk(idx, root));
+		idx.cancel();
+	}
+
+	// Searches in the background find the same paths, also by patterns without a literal word, which are
+	// matched against all the names, and stop at the maximum
+	void test_search(const fs::path& dir) {
+		const auto root = dir / "root";
+		PathIndex idx;
+		std::atomic<int> notified{};
+		idx.set_notifier([&] { ++notified; });
+		idx.start(check::wide(dir / "index.dat"), { check::wide(root) });
+		wait(idx);
+		for (const auto& w : words) {
+			CHECK(search(idx, [&](Matcher& m) { m.set_literal(w); }, SIZE_MAX) == walk(root, w));
+		}
+		CHECK(notified > 0);
+
+		auto expect = walk(root, L"sub1");
+		expect.merge(walk(root, L"report_2"));
+		CHECK(search(idx, [](Matcher& m) { m.set_pattern(L"(sub1|report_2)"); }, SIZE_MAX) == expect);
+		CHECK(search(idx, [](Matcher& m) { m.set_literal(L"txt"); }, 10).size() == 10);
+
+		DirectoryLister::Batch batch;
+		idx.search([](Matcher& m) { m.set_literal(L"txt"); }, SIZE_MAX);
+		idx.cancel_search();
+		CHECK(idx.take(batch));
+		CHECK(batch.size() == 0);
+		idx.cancel();
+	}
+
+	// Builds started again before the previous ones end, which are left to end on their own, leave the
+	// index of the last one
+	void test_restart(const fs::path& dir) {
+		const auto root = dir / "root";
+		const auto file = check::wide(dir / "index.dat");
+		PathIndex idx;
+		for (int i = 0; i < 10; ++i) {
+			idx.start(file, { check::wide(root / ("folder" + std::to_string(i))) });
+			if (i % 2) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		idx.start(file, { check::wide(root) });
+		wait(idx);
+		CHECK(same_as_walk(idx, root));
+		idx.cancel();
+		CHECK(!idx.is_building());
+		CHECK(same_as_walk(idx, root));
+	}
+
+	// Truncated indexes are rejected and built again
+	void test_truncated(const fs::path& dir) {
+		const auto root = dir / "root";
+		const auto file = dir / "index.dat";
+		std::string bytes;
+		{
+			std::ifstream ifs(file, std::ios::binary);
+			bytes.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+		}
+		CHECK(!bytes.empty());
+		for (size_t n = 0; n < bytes.size(); n += 1 + n / 8) {
+			std::ofstream(file, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(n));
+			PathIndex idx;
+			idx.start(check::wide(file), { check::wide(root) });
+			wait(idx);
+			CHECK(same_as_walk(idx, root));
+			idx.cancel();
+		}
+	}
+
+	// Indexes whose postings at the tail are broken are queried without reading out of them while they are
+	// used, and built again
+	void test_corrupted(const fs::path& dir) {
+		const auto root = dir / "root";
+		const auto file = dir / "index.dat";
+		std::string bytes;
+		{
+			std::ifstream ifs(file, std::ios::binary);
+			bytes.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+		}
+		CHECK(!bytes.empty());
+		std::set<std::wstring> tris;  // Words whose postings are used as they are, of the names and the root
+		const auto add = [&](const std::wstring& n) {
+			for (size_t k = 0; k + 3 <= n.size(); ++k) tris.insert(n.substr(k, 3));
+		};
+		add(check::wide(root));
+		for (const auto& e : fs::recursive_directory_iterator(root)) add(check::wide(e.path().filename()));
+		for (size_t i = bytes.size() - bytes.size() / 8; i + 5 <= bytes.size(); i += 61) {
+			auto b = bytes;
+			b.replace(i, 5, "\xFF\xFF\xFF\xFF\x07");  // Delta of a posting running far over the entries
+			std::ofstream(file, std::ios::binary | std::ios::trunc).write(b.data(), static_cast<std::streamsize>(b.size()));
+			PathIndex idx;
+			idx.start(check::wide(file), { check::wide(root) });
+			idx.cancel();  // Stopped before it is built, leaving the index mapped
+			for (const auto& w : tris) query(idx, w);
+			idx.start(check::wide(file), { check::wide(root) });
+			wait(idx);
+			CHECK(same_as_walk(idx, root));
+			idx.cancel();
+		}
+	}
+
+}
+
+int main() {
+	const auto dir = check::temp_dir("path_index");
+	test_build(dir);
+	test_round_trip(dir);
+	test_search(dir);
+	test_restart(dir);
+	test_truncated(dir);
+	test_corrupted(dir);
+	return check::result();
+}
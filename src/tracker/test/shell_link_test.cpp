@@ -0,0 +1,176 @@
+/**
+ * Test of Reading Targets of Shortcut Files, Including Truncated Ones
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <initializer_list>
+
+#include "check.h"
+#include "shell_link.hpp"
+
+namespace {
+
+	std::string u16(uint32_t v) {
+		return { static_cast<char>(v & 0xFF), static_cast<char>((v >> 8) & 0xFF) };
+	}
+
+	std::string u32(uint32_t v) {
+		return u16(v & 0xFFFF) + u16(v >> 16);
+	}
+
+	std::string ansi(std::string_view s) {
+		return std::string{ s } + '\0';
+	}
+
+	std::string unicode(std::wstring_view s) {
+		std::string ret;
+		for (const wchar_t c : s) ret += u16(static_cast<uint32_t>(c));
+		return ret + u16(0);
+	}
+
+	std::string header(uint32_t flags) {
+		std::string h = u32(shell_link::HEADER_SIZE) + std::string{ shell_link::LINK_CLSID } + u32(flags) + u32(0x20);
+		h.resize(shell_link::HEADER_SIZE, '\0');
+		return h;
+	}
+
+	std::string terminal() {
+		return u32(0);
+	}
+
+	// LinkInfo of a local path, with its Unicode strings when given
+	std::string link_info_local(std::string_view base, std::string_view suffix, std::wstring_view base_u = {}, std::wstring_view suffix_u = {}) {
+		const bool uni = !base_u.empty();
+		const uint32_t hs = uni ? 0x24 : 0x1C;
+		const std::string vol_id = u32(0x11) + u32(3) + u32(0) + u32(0x10) + '\0';
+		const auto b = ansi(base), s = ansi(suffix);
+		const uint32_t o_vol = hs, o_lbp = o_vol + static_cast<uint32_t>(vol_id.size()), o_cps = o_lbp + static_cast<uint32_t>(b.size());
+		uint32_t end = o_cps + static_cast<uint32_t>(s.size());
+		std::string extra, tail;
+		if (uni) {
+			if (end % 2) {
+				extra += '\0';
+				++end;
+			}
+			const auto bu = unicode(base_u), su = unicode(suffix_u);
+			tail = u32(end) + u32(end + static_cast<uint32_t>(bu.size()));
+			extra += bu + su;
+		}
+		const std::string body = u32(hs) + u32(1) + u32(o_vol) + u32(o_lbp) + u32(0) + u32(o_cps) + tail + vol_id + b + s + extra;
+		return u32(static_cast<uint32_t>(body.size()) + 4) + body;
+	}
+
+	std::string link_info_net(std::string_view net, std::string_view suffix) {
+		const std::string cn_body = u32(2) + u32(0x14) + u32(0) + u32(0x20000) + ansi(net);
+		const std::string cn = u32(static_cast<uint32_t>(cn_body.size()) + 4) + cn_body;
+		const uint32_t hs = 0x1C;
+		const std::string body = u32(hs) + u32(2) + u32(0) + u32(0) + u32(hs) + u32(hs + static_cast<uint32_t>(cn.size())) + cn + ansi(suffix);
+		return u32(static_cast<uint32_t>(body.size()) + 4) + body;
+	}
+
+	std::string id_list(std::initializer_list<std::string> items) {
+		std::string b;
+		for (const auto& i : items) b += u16(static_cast<uint32_t>(i.size()) + 2) + i;
+		b += u16(0);
+		return u16(static_cast<uint32_t>(b.size())) + b;
+	}
+
+	std::string root_item() {
+		return std::string{ "\x1F\x50", 2 } + std::string(16, '\x11');
+	}
+
+	std::string volume_item(std::string_view drive) {
+		std::string v(1, '\x2F');
+		v.append(ansi(drive));
+		v.resize(23, '\0');
+		return v;
+	}
+
+	// File entry with its long name in the extension block
+	std::string file_entry(std::string_view short_name, std::wstring_view long_name, bool dir) {
+		std::string body = std::string{ static_cast<char>(dir ? 0x31 : 0x32), '\0' } + u32(0) + u32(0) + u16(0x10) + ansi(short_name);
+		if (body.size() % 2) body += '\0';
+		const auto off = static_cast<uint32_t>(body.size()) + 2;
+		std::string ext = u16(0) + u16(9) + u32(shell_link::FILE_ENTRY_EXTENSION_BLOCK) + u32(0) + u32(0) + u16(46);
+		ext.resize(46, '\0');
+		ext += unicode(long_name) + u16(0);
+		ext.replace(0, 2, u16(static_cast<uint32_t>(ext.size())));
+		return body + ext + u16(off);
+	}
+
+	std::string string_data(std::wstring_view s) {
+		std::string ret = u16(static_cast<uint32_t>(s.size()));
+		for (const wchar_t c : s) ret += u16(static_cast<uint32_t>(c));
+		return ret;
+	}
+
+	std::string environment(std::string_view target) {
+		std::string a = ansi(target), w = unicode(std::wstring{ target.begin(), target.end() });
+		a.resize(260, '\0');
+		w.resize(520, '\0');
+		return u32(788) + u32(shell_link::ENVIRONMENT_VARIABLE_DATA_BLOCK) + a + w;
+	}
+
+	struct Case {
+		std::string data;
+		std::wstring target;
+		std::vector<std::wstring> partial;  // Targets read from truncated data besides an empty one
+	};
+
+	std::vector<Case> cases() {
+		using namespace shell_link;
+		const std::wstring cyr = L"\x0414\x043E\x043A";
+		return {
+			{ header(HAS_LINK_INFO | IS_UNICODE) + link_info_local("C:\\Program Files\\App", "app.exe") + terminal(), L"C:\\Program Files\\App\\app.exe", {} },
+			{ header(HAS_LINK_INFO | IS_UNICODE) + link_info_local("C:\\Users\\me\\", "?", L"C:\\Users\\me\\", cyr) + terminal(), L"C:\\Users\\me\\" + cyr, {} },
+			{ header(HAS_LINK_INFO | IS_UNICODE) + link_info_net("\\\\server\\share", "dir\\file.txt") + terminal(), L"\\\\server\\share\\dir\\file.txt", {} },
+			{ header(HAS_LINK_TARGET_ID_LIST | IS_UNICODE) + id_list({ root_item(), volume_item("C:\\"), file_entry("PROGRA~1", L"Program Files", true), file_entry("MYAPP~1.EXE", L"My App.exe", false) }) + terminal(), L"C:\\Program Files\\My App.exe", {} },
+			{ header(HAS_LINK_TARGET_ID_LIST | HAS_LINK_INFO | HAS_NAME | HAS_RELATIVE_PATH | HAS_WORKING_DIR | IS_UNICODE) + id_list({ root_item(), volume_item("C:\\"), file_entry("X", L"x", true) }) + link_info_local("E:\\", "target.txt") + string_data(L"desc") + string_data(L"..\\rel") + string_data(L"C:\\wd") + terminal(), L"E:\\target.txt", {} },
+			{ header(HAS_LINK_INFO | IS_UNICODE | HAS_EXP_STRING | HAS_ARGUMENTS) + link_info_local("C:\\Windows\\", "notepad.exe") + string_data(L"-x") + environment("%windir%\\notepad.exe") + terminal(), L"%windir%\\notepad.exe", { L"C:\\Windows\\notepad.exe" } },
+		};
+	}
+
+	void test_targets() {
+		for (const auto& c : cases()) CHECK(shell_link::parse(c.data) == c.target);
+		CHECK(shell_link::parse(std::string(200, 'x')).empty());
+		CHECK(shell_link::parse({}).empty());
+	}
+
+	// Data cut anywhere is read up to its end, giving nothing or a target stored before the cut
+	void test_truncated() {
+		for (const auto& c : cases()) {
+			for (size_t n = 0; n < c.data.size(); ++n) {
+				const std::string cut = c.data.substr(0, n);  // Copied so that nothing follows it
+				const auto t = shell_link::parse(cut);
+				CHECK(t.empty() || t == c.target || std::find(c.partial.begin(), c.partial.end(), t) != c.partial.end());
+			}
+		}
+	}
+
+	// Offsets and sizes broken by single bytes are not followed out of the data
+	void test_corrupted() {
+		for (const auto& c : cases()) {
+			for (size_t i = 0; i < c.data.size(); ++i) {
+				for (const char b : { '\x00', '\x7F', '\xFF' }) {
+					std::string d = c.data;
+					d[i] = b;
+					shell_link::parse(d);
+				}
+			}
+		}
+	}
+
+}
+
+int main() {
+	test_targets();
+	test_truncated();
+	test_corrupted();
+	return check::result();
+}
@@ -0,0 +1,126 @@
+/**
+ * Test of the Size Calculator against a Walk of the Folders
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+#include "size_calculator.h"
+
+namespace {
+
+	namespace fs = std::filesystem;
+
+	void make_tree(const fs::path& root) {
+		int seq = 0;
+		for (int a = 0; a < 6; ++a) {
+			for (int b = 0; b < 5; ++b) {
+				for (int c = 0; c < 4; ++c) {
+					const auto dir = root / ("top" + std::to_string(a)) / ("mid" + std::to_string(b)) / ("low" + std::to_string(c));
+					fs::create_directories(dir);
+					for (int f = 0; f < 10; ++f, ++seq) {
+						std::ofstream(dir / ("file" + std::to_string(f) + ".bin"), std::ios::binary) << std::string(static_cast<size_t>(seq * 37 % 500), 'x');
+					}
+				}
+			}
+		}
+		std::ofstream(root / "top0" / "own.bin", std::ios::binary) << std::string(123, 'y');
+	}
+
+	// Total size of the files below the folder, found by walking it
+	uint64_t walk(const fs::path& dir) {
+		uint64_t size = 0;
+		for (const auto& e : fs::recursive_directory_iterator(dir)) {
+			if (e.is_regular_file()) size += e.file_size();
+		}
+		return size;
+	}
+
+	// Totals of folders and files are those of the walk, by one worker and by several, and again from the
+	// sizes cached
+	void test_calc(const fs::path& root) {
+		const auto expected = walk(root);
+		for (const size_t threads : { size_t{ 1 }, size_t{ 4 } }) {
+			SizeCache cache;
+			SizeCalculator calc(cache);
+			uint64_t size{};
+			CHECK(calc.calc({ check::wide(root) }, size, 0, threads));
+			CHECK(size == expected);
+			CHECK(calc.calc({ check::wide(root) }, size, 0, threads));
+			CHECK(size == expected);
+
+			const auto file = root / "top0" / "own.bin";
+			CHECK(calc.calc({ check::wide(root / "top1"), check::wide(file) }, size, 0, threads));
+			CHECK(size == walk(root / "top1") + fs::file_size(file));
+		}
+	}
+
+	// Each folder is passed on once with its own total
+	void test_calc_each(const fs::path& root) {
+		std::vector<std::wstring> dirs;
+		for (int a = 0; a < 6; ++a) dirs.push_back(check::wide(root / ("top" + std::to_string(a))));
+		SizeCache cache;
+		SizeCalculator calc(cache);
+		uint64_t size{};
+		CHECK(calc.calc({ dirs[2] }, size, 0, 2));  // Taken from the cache
+
+		std::mutex m;
+		std::map<size_t, uint64_t> sizes;
+		size_t calls = 0;
+		CHECK(calc.calc_each(dirs, [&](size_t i, uint64_t s) {
+			std::lock_guard lock(m);
+			sizes[i] = s;
+			++calls;
+		}, 4));
+		CHECK(calls == dirs.size());
+		for (size_t i = 0; i < dirs.size(); ++i) CHECK(sizes[i] == walk(root / ("top" + std::to_string(i))));
+	}
+
+	// Calculations stopped or over the time limit end with the size counted so far, and only the folders done
+	// are cached, so that the next calculation gives the right totals
+	void test_stop(const fs::path& root) {
+		const auto expected = walk(root);
+		SizeCache cache;
+		SizeCalculator calc(cache);
+		uint64_t size{};
+		std::stop_source stopped;
+		stopped.request_stop();
+		if (!calc.calc({ check::wide(root) }, size, 0, 4, stopped.get_token())) CHECK(size <= expected);
+		if (!calc.calc({ check::wide(root) }, size, 1, 4)) CHECK(size <= expected);
+
+		for (int i = 0; i < 20; ++i) {
+			SizeCache c;
+			SizeCalculator sc(c);
+			std::stop_source ss;
+			std::jthread stopper([&] {
+				std::this_thread::sleep_for(std::chrono::microseconds(100 * i));
+				ss.request_stop();
+			});
+			const bool done = sc.calc({ check::wide(root) }, size, 0, 4, ss.get_token());
+			CHECK(done ? size == expected : size <= expected);
+			stopper.join();
+			CHECK(sc.calc({ check::wide(root) }, size, 0, 4));
+			CHECK(size == expected);
+		}
+	}
+
+}
+
+int main() {
+	const auto root = check::temp_dir("size_calculator") / "root";
+	make_tree(root);
+	test_calc(root);
+	test_calc_each(root);
+	test_stop(root);
+	return check::result();
+}
@@ -0,0 +1,80 @@
+/**
+ * Test of the Radix and the Parallel Sorts against std::stable_sort
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "type_table.h"
+#include "directory_snapshot.h"
+#include "comparator.h"
+#include "sort_engine.hpp"
+
+namespace {
+
+	// Names, sizes and times drawn from small sets so that many rows tie
+	void fill(DirectorySnapshot& snap, size_t n, const TypeTable& exts) {
+		static const wchar_t* stems[] = { L"IMG_", L"report", L"Document ", L"track", L"data-" };
+		static const wchar_t* ext[]   = { L".jpg", L".txt", L"", L".md" };
+		std::mt19937_64 rng(3);
+		snap.set_parent(L"/test/");
+		for (size_t i = 0; i < n; ++i) {
+			const auto r = rng();
+			const bool dir = r % 10 == 0;
+			std::wstring name{ stems[r % 5] };
+			name.append(std::to_wstring((r >> 8) % 500));
+			if (!dir) name.append(ext[(r >> 20) % 4]);
+			snap.add_file(os::FindData{ name, dir ? os::ATTR_DIRECTORY : 0, (r >> 24) % 50, os::EPOCH_DIFF_TICKS + (r >> 32) % 50 }, exts);
+		}
+		snap.prepare_keys();
+	}
+
+	// Same rows in an order equivalent to that of std::stable_sort
+	template<typename C> bool same_order(const std::vector<uint32_t>& rows, const C& cmp) {
+		std::vector<uint32_t> ref(rows.size());
+		std::iota(ref.begin(), ref.end(), uint32_t{ 0 });
+		std::stable_sort(ref.begin(), ref.end(), cmp);
+		if (!check::same_rows(rows, ref)) return false;
+		for (size_t i = 0; i < rows.size(); ++i) {
+			if (cmp(rows[i], ref[i]) || cmp(ref[i], rows[i])) return false;
+		}
+		return true;
+	}
+
+	template<typename C, bool Radix> void test(const DirectorySnapshot& snap) {
+		for (const bool rev : { false, true }) {
+			const C cmp(snap, rev);
+			std::vector<uint32_t> rows(snap.size());
+			std::iota(rows.begin(), rows.end(), uint32_t{ 0 });
+			std::shuffle(rows.begin(), rows.end(), std::mt19937{ 5 });
+			auto par = rows;
+			sort_engine::parallel_sort(par, cmp, 4);
+			CHECK(same_order(par, cmp));
+			if constexpr (Radix) {
+				sort_engine::radix_sort_by(rows, cmp);
+				CHECK(same_order(rows, cmp));
+			}
+		}
+	}
+
+}
+
+int main() {
+	const TypeTable exts;
+	for (const size_t n : { size_t{ 0 }, size_t{ 1 }, size_t{ 100 }, size_t{ 40000 } }) {
+		DirectorySnapshot snap;
+		fill(snap, n, exts);
+		test<CompByName, false>(snap);
+		test<CompByType, false>(snap);
+		test<CompByDate, true>(snap);
+		test<CompBySize, true>(snap);
+	}
+	return check::result();
+}
@@ -0,0 +1,92 @@
+/**
+ * Test of the Subtree Searcher against a Walk of the Folders
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "check.h"
+#include "subtree_searcher.h"
+
+namespace {
+
+	namespace fs = std::filesystem;
+
+	void make_tree(const fs::path& root) {
+		for (int d = 0; d < 30; ++d) {
+			const auto dir = root / ("folder" + std::to_string(d % 6)) / ("sub" + std::to_string(d));
+			fs::create_directories(dir);
+			for (int f = 0; f < 20; ++f) {
+				std::ofstream(dir / ("report_" + std::to_string(d * 100 + f) + ".txt")) << f;
+			}
+		}
+	}
+
+	// Paths relative to the root whose names contain the word, found by walking the folders
+	std::set<std::wstring> walk(const fs::path& root, const std::wstring& word) {
+		std::set<std::wstring> ret;
+		for (const auto& e : fs::recursive_directory_iterator(root)) {
+			if (check::wide(e.path().filename()).find(word) != std::wstring::npos) ret.insert(check::wide(e.path().lexically_relative(root)));
+		}
+		return ret;
+	}
+
+	// Files taken until the search is done
+	std::set<std::wstring> take_all(SubtreeSearcher& ss) {
+		std::set<std::wstring> ret;
+		DirectoryLister::Batch batch;
+		for (bool done = false; !done; ) {
+			done = ss.take(batch);
+			for (size_t i = 0; i < batch.size(); ++i) ret.emplace(batch.at(i).name);
+			if (!done) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return ret;
+	}
+
+	// The same files are found by one worker and by several, and the last files found are notified
+	void test_search(const fs::path& root) {
+		std::atomic<int> notified{};
+		SubtreeSearcher ss;
+		ss.set_notifier([&] { ++notified; });
+		for (const std::wstring word : { L"report_1", L"sub2", L"txt", L"none" }) {
+			for (const size_t threads : { size_t{ 1 }, size_t{ 4 } }) {
+				notified = 0;
+				ss.start(check::wide(root), [&](Matcher& m) { m.set_literal(word); }, threads);
+				CHECK(take_all(ss) == walk(root, word));
+				CHECK(notified > 0);
+			}
+		}
+	}
+
+	// Files of a search canceled are not mixed into the next one
+	void test_cancel(const fs::path& root) {
+		SubtreeSearcher ss;
+		DirectoryLister::Batch batch;
+		for (int i = 0; i < 20; ++i) {
+			ss.start(check::wide(root), [](Matcher& m) { m.set_literal(L"txt"); }, 4);
+			if (i % 2) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			ss.cancel();
+			CHECK(ss.take(batch));
+			CHECK(batch.size() == 0);
+			ss.start(check::wide(root), [](Matcher& m) { m.set_literal(L"sub1"); }, 4);
+			CHECK(take_all(ss) == walk(root, L"sub1"));
+		}
+	}
+
+}
+
+int main() {
+	const auto root = check::temp_dir("subtree_searcher") / "root";
+	make_tree(root);
+	test_search(root);
+	test_cancel(root);
+	return check::result();
+}
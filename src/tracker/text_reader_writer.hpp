@@ -2,7 +2,7 @@
  * Reader and Writer of Text Files
  *
  * @author Takuto Yanagida
- * @version 2026-05-13
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -10,15 +10,16 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <iterator>
 
 #include "gsl/gsl"
-#include "file_utils.hpp"
+#include "os.hpp"
 
 namespace text_reader_writer {
 
-	std::vector<std::wstring> read(const std::wstring& path) {
+	inline std::vector<std::wstring> read(const std::wstring& path) {
 		std::vector<std::wstring> lines{};
-		std::ifstream ifs(path, std::ios::binary);
+		std::ifstream ifs(os::native_path(path), std::ios::binary);
 		if (!ifs) return lines;
 
 		ifs.seekg(0, std::ios::end);
@@ -40,17 +41,17 @@ namespace text_reader_writer {
 
 		if (remain <= 0 || (remain % 2) != 0) return lines;
 
-		std::wstring text;
-		text.resize(gsl::narrow<size_t>(remain / 2));
-		[[gsl::suppress("type.1")]]
-		if (!ifs.read(reinterpret_cast<char*>(text.data()), remain)) {
+		std::string bytes;
+		bytes.resize(gsl::narrow<size_t>(remain));
+		if (!ifs.read(bytes.data(), remain)) {
 			const auto got = gsl::narrow<size_t>(ifs.gcount());
 			if (got % 2 == 0) {
-				text.resize(got / 2);
+				bytes.resize(got);
 			} else {
 				return lines;
 			}
 		}
+		const std::wstring text = os::from_utf16le(bytes);
 
 		size_t pos = 0;
 		const size_t n = text.size();
@@ -70,22 +71,24 @@ namespace text_reader_writer {
 		return lines;
 	}
 
-	void write(const std::wstring& path, const std::vector<std::wstring>& lines) {
-		std::ofstream ofs(path, std::ios::binary);
-		if (!ofs) return;
+	// Read a whole text file in Shift_JIS, such as the dictionaries of Migemo
+	inline std::wstring read_cp932(const std::wstring& path) {
+		std::ifstream ifs(os::native_path(path), std::ios::binary);
+		if (!ifs) return {};
+		const std::string bytes{ std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>() };
+		return os::from_cp932(bytes);
+	}
 
-		const unsigned char bom[2]{0xFF, 0xFE};
-		[[gsl::suppress("type.1")]]
-		ofs.write(reinterpret_cast<const char*>(bom), sizeof(bom));
+	inline void write(const std::wstring& path, const std::vector<std::wstring>& lines) {
+		std::ofstream ofs(os::native_path(path), std::ios::binary);
+		if (!ofs) return;
 
+		std::string bytes{ "\xFF\xFE" };  // BOM
 		for (const auto& line : lines) {
-			[[gsl::suppress("type.1")]]
-			ofs.write(reinterpret_cast<const char*>(line.data()), gsl::narrow<std::streamsize>(line.size() * sizeof(wchar_t)));
-
-			const wchar_t crlf[] = L"\r\n";
-			[[gsl::suppress("type.1")]]
-			ofs.write(reinterpret_cast<const char*>(crlf), gsl::narrow<std::streamsize>(2 * sizeof(wchar_t)));
+			os::append_utf16le(bytes, line);
+			os::append_utf16le(bytes, L"\r\n");
 		}
+		ofs.write(bytes.data(), gsl::narrow<std::streamsize>(bytes.size()));
 		ofs.close();
 	}
 
@@ -0,0 +1,33 @@
+/**
+ * Compiler of the Migemo Dictionary into the Image Mapped at Startup
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "os.hpp"
+#include "migemo_dict.h"
+
+int main(int argc, char* argv[]) {
+	if (argc != 2) {
+		std::fprintf(stderr, "usage: %s path/to/dict/migemo-dict\n", argv[0]);
+		return 1;
+	}
+	const std::wstring path = os::from_utf8(argv[1]);
+	std::vector<uint32_t> image;
+	if (!MigemoDict::compile(path, image)) {
+		std::fprintf(stderr, "cannot read %s\n", argv[1]);
+		return 1;
+	}
+	const auto img = MigemoDict::image_path(path);
+	if (!MigemoDict::save(img, image)) {
+		std::fprintf(stderr, "cannot write %s\n", os::to_utf8(img).c_str());
+		return 1;
+	}
+	std::printf("%s (%zu bytes)\n", os::to_utf8(img).c_str(), image.size() * sizeof(uint32_t));
+	return 0;
+}
@@ -2,7 +2,7 @@
  * Common Header
  *
  * @author Takuto Yanagida
- * @version 2026-05-13
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -12,6 +12,7 @@
 
 #define WM_REQUESTUPDATE    (WM_APP + 1)
 #define WM_RENAMEEDITCLOSED (WM_APP + 2)
+#define WM_LISTINGUPDATE    (WM_APP + 3)
 
 //
 // Sections and Keys of INI File -----------------------------------------------
@@ -45,6 +46,8 @@ const std::wstring SECTION_WINDOW(L"Window");
 	const std::wstring KEY_FONT_SIZE(L"FontSize");					constexpr int VAL_FONT_SIZE = 16;
 
 	const std::wstring KEY_USE_MIGEMO(L"UseMigemo");				constexpr int VAL_USE_MIGEMO = 0;
+	const std::wstring KEY_FILTER_SEARCH(L"FilterSearch");		constexpr int VAL_FILTER_SEARCH = 0;
+	const std::wstring KEY_FUZZY_SEARCH(L"FuzzySearch");		constexpr int VAL_FUZZY_SEARCH = 0;
 
 const std::wstring SECTION_BOOKMARK(L"Favorite");
 
@@ -0,0 +1,45 @@
+/**
+ * Core Library (Headers Shared with the GUI)
+ *
+ * @author Takuto Yanagida
+ * @version 2026-10-17
+ */
+
+#include "os.hpp"
+#include "collator.hpp"
+#include "path.hpp"
+#include "file_system.hpp"
+#include "shell_link.hpp"
+#include "shortcut.hpp"
+#include "text_reader_writer.hpp"
+#include "pref.hpp"
+#include "type_table.h"
+#include "directory_snapshot.h"
+#include "item.h"
+#include "item_list.h"
+#include "listing_arena.h"
+#include "directory_lister.h"
+#include "subtree_searcher.h"
+#include "change_journal.h"
+#include "path_index.h"
+#include "size_cache.h"
+#include "size_calculator.h"
+#include "folder_sizer.h"
+#include "link_resolver.h"
+#include "existence_checker.h"
+#include "directory_watcher.h"
+#include "listing_cache.h"
+#include "comparator.h"
+#include "sort_engine.hpp"
+#include "matcher.h"
+#include "fuzzy_scorer.h"
+#include "conversion_table.h"
+#include "mapped_file.h"
+#include "migemo_dict.h"
+#include "regex_generator.h"
+#include "migemo_engine.h"
+#include "option.h"
+#include "search.h"
+#include "history.h"
+#include "bookmark.h"
+#include "hier_transition.h"
@@ -2,13 +2,15 @@
  * Table for Managing File Types
  *
  * @author Takuto Yanagida
- * @version 2026-04-30
+ * @version 2026-10-17
  */
 
 #pragma once
 
 #include <map>
 #include <string>
+#include <algorithm>
+#include <cwctype>
 
 #include "pref.hpp"
 
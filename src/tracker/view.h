@@ -2,7 +2,7 @@
  * View
  *
  * @author Takuto Yanagida
- * @version 2026-05-13
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -29,6 +29,7 @@
 #include "tool_tip.h"
 
 constexpr auto IDHK = 1;
+constexpr auto IDT_INFO_SIZE = 2;
 
 BOOL init_application(HINSTANCE inst, const wchar_t* class_name) noexcept;
 LRESULT CALLBACK wnd_proc(HWND wnd, UINT msg, WPARAM wp, LPARAM lp);
@@ -43,6 +44,8 @@ class View : public Observer {
 	static constexpr auto SEL   = 32;
 	static constexpr auto EMPTY = 64;
 
+	inline static const std::wstring MIGEMO_IMAGE_FILE_NAME{ L"migemo-dict.img" };  // Cache of the Migemo dictionary
+
 	int mouse_down_y_ = -1;
 	int mouse_down_area_ = -1;
 	std::optional<size_t> mouse_down_idx_;
@@ -64,6 +67,7 @@ class View : public Observer {
 	Pref pref_;
 	int popup_pos_{};
 	bool full_screen_check_{};
+	HMENU info_menu_{};  // Information popup being shown while its size is calculated
 
 	static int& menu_top_() noexcept {
 		static int menu_top_;
@@ -101,7 +105,7 @@ class View : public Observer {
 	}
 
 	size_t skip_hier_separator(size_t index, bool forward) {
-		if ((doc_.get_navis().at(index)->data() & SEPA) == 0) return index;
+		if ((doc_.get_navis().at(index).data() & SEPA) == 0) return index;
 		return forward ? index + 1 : index - 1;
 	}
 
@@ -137,6 +141,8 @@ public:
 
 	void initialize() {
 		doc_.set_observer(this);
+		doc_.set_listing_notifier([wnd = wnd_]() noexcept { ::PostMessage(wnd, WM_LISTINGUPDATE, 0, 0); });
+		doc_.set_device_window(wnd_);
 
 		ope_.set_window_handle(wnd_);
 		re_.initialize(wnd_);
@@ -173,7 +179,9 @@ public:
 		const std::wstring font_name = pref_.item(KEY_FONT_NAME, VAL_FONT_NAME);
 		const int          font_size = std::lrint(pref_.item_int(KEY_FONT_SIZE, VAL_FONT_SIZE) * dpi_fact_x_);
 
-		const bool use_migemo = pref_.item_int(KEY_USE_MIGEMO, VAL_USE_MIGEMO) != 0;
+		const bool use_migemo    = pref_.item_int(KEY_USE_MIGEMO, VAL_USE_MIGEMO) != 0;
+		const bool filter_search = pref_.item_int(KEY_FILTER_SEARCH, VAL_FILTER_SEARCH) != 0;
+		const bool fuzzy_search  = pref_.item_int(KEY_FUZZY_SEARCH, VAL_FUZZY_SEARCH) != 0;
 
 		::MoveWindow(wnd_, 0, 0, width, height, FALSE);
 		::ShowWindow(wnd_, SW_SHOW);  // Once display, and calculate the size etc.
@@ -190,7 +198,7 @@ public:
 		font_mark_ = ::CreateFont(std::lrint(14 * dpi_fact_x_), 0, 0, 0, FW_REGULAR, FALSE, FALSE, FALSE, SYMBOL_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, PROOF_QUALITY, DEFAULT_PITCH | FF_DONTCARE, _T("Marlett"));
 		re_.set_font(font_item_);
 
-		search_.initialize(use_migemo);
+		search_.initialize(use_migemo, filter_search, fuzzy_search, path::parent(pref_.path()).append(1, path::PATH_SEPARATOR).append(MIGEMO_IMAGE_FILE_NAME));
 		extensions_.restore(pref_);  // Load extension color
 
 		doc_.initialize(is_first_time);
@@ -292,6 +300,10 @@ public:
 		doc_.Update();
 	}
 
+	void wm_listing_update() {
+		doc_.receive_listed_files();
+	}
+
 	void wm_rename_edit_closed() {
 		auto& renamedPath = re_.get_rename_path();
 		auto& newFileName = re_.get_new_file_name();
@@ -336,6 +348,7 @@ public:
 		RECT rc{};
 		PAINTSTRUCT ps{};
 
+		doc_.resolve_links(scroll_list_top_idx_, scroll_list_top_idx_ + scroll_list_line_num_ + 1);  // Only those shown
 		::GetClientRect(wnd_, &rc);
 		auto dc = ::BeginPaint(wnd_, &ps);
 
@@ -356,14 +369,15 @@ public:
 				if (i < navis.size()) {
 					const auto it = navis.at(i);
 					if (!it) continue;
-					if ((it->data() & SEPA) != 0) {
-						draw_separator(dc, r, (it->data() == (SEPA | HIER)));
+					if ((it.data() & SEPA) != 0) {
+						draw_separator(dc, r, (it.data() == (SEPA | HIER)));
 					} else {
-						draw_item(dc, r, it.get(), list_cursor_switch_ == Document::ListType::HIER && i == list_cursor_idx_);
+						draw_item(dc, r, &it, list_cursor_switch_ == Document::ListType::HIER && i == list_cursor_idx_);
 					}
 				} else if (i - navis.size() + scroll_list_top_idx_ < files.size()) {
 					const size_t t = i - navis.size() + scroll_list_top_idx_;
-					draw_item(dc, r, files.at(t).get(), list_cursor_switch_ == Document::ListType::FILE && t == list_cursor_idx_);
+					const auto it = files.at(t);
+					draw_item(dc, r, &it, list_cursor_switch_ == Document::ListType::FILE && t == list_cursor_idx_);
 				} else {
 					::FillRect(dc, &r, ::GetSysColorBrush(COLOR_MENU));
 				}
@@ -476,10 +490,10 @@ public:
 		if (fd->is_dir()) r.right -= cx_side_;
 		SIZE font{};
 		if (cur) {
-			::GetTextExtentPoint32(dc, fd->name().c_str(), gsl::narrow<int>(fd->name().size()), &font);
+			::GetTextExtentPoint32(dc, fd->name().data(), gsl::narrow<int>(fd->name().size()), &font);
 			is_cur_sel_long_ = font.cx > r.right - r.left;  // File name at cursor position is out
 		}
-		::DrawText(dc, fd->name().c_str(), -1, &r, DT_VCENTER | DT_SINGLELINE | DT_NOPREFIX | ((is_cur_sel_long_ && cur) ? cursor_align_ : 0));
+		::DrawText(dc, fd->name().data(), -1, &r, DT_VCENTER | DT_SINGLELINE | DT_NOPREFIX | ((is_cur_sel_long_ && cur) ? cursor_align_ : 0));
 	}
 
 	// Draw a mark
@@ -506,7 +520,21 @@ public:
 		if (dir) ::DrawText(dc, _T("4"), 1, &rr, 0x0025);
 	}
 
-	void wm_timer() {
+	// Release the folders on a device about to be removed so that the removal is not blocked
+	void wm_device_change(WPARAM type, LPARAM data) {
+		if (type != DBT_DEVICEQUERYREMOVE || !data) return;
+		[[gsl::suppress("type.1")]]
+		const auto* hdr = reinterpret_cast<const DEV_BROADCAST_HDR*>(data);
+		if (hdr->dbch_devicetype != DBT_DEVTYP_HANDLE) return;
+		[[gsl::suppress("type.1")]]
+		doc_.release_device(reinterpret_cast<const DEV_BROADCAST_HANDLE*>(data)->dbch_handle);
+	}
+
+	void wm_timer(UINT_PTR id) {
+		if (id == IDT_INFO_SIZE) {
+			update_info_size();
+			return;
+		}
 		if (::IsWindowVisible(wnd_)) {
 			if (wnd_ != ::GetForegroundWindow()) {  // If the window is displayed but somehow it is not the front
 				DWORD id, fid;
@@ -516,7 +544,8 @@ public:
 			}
 			// Search delay processing
 			if (search_.is_reserved()) {
-				set_cursor_index(search_.find_first(list_cursor_idx_, doc_.get_files()), Document::ListType::FILE);
+				if (doc_.in_subtree_search()) search_subtree();
+				else set_cursor_index(search_.find_first(list_cursor_idx_, doc_.get_files()), Document::ListType::FILE);
 			}
 			return;
 		}
@@ -730,28 +759,34 @@ public:
 
 	// Click on the separator
 	bool on_separator_click(int vkey, size_t index, int x, Document::ListType type) {
-		if ((doc_.get_item(type, index)->data() & SEPA) == 0) return false;
+		if ((doc_.get_item(type, index).data() & SEPA) == 0) return false;
 
 		if (doc_.in_history()) {  // Click history separator
 			if (vkey == VK_LBUTTON) action(CMD_CLEAR_HISTORY, type, index);
 			return true;
 		}
-		if (doc_.get_item(type, index)->data() == (SEPA | HIER)) {  // Click the hierarchy separator
+		if (doc_.get_item(type, index).data() == (SEPA | HIER)) {  // Click the hierarchy separator
 			if (list_rect_.right * 2 / 3 < x) {  // If it is more than two thirds
 				select_file(0, doc_.get_file_count() - 1);
 			} else {
 				int sortBy = doc_.get_option().get_sort_type();
+				ht_.set_index(0U);
 				switch (vkey) {
 				case VK_LBUTTON:
 					if (++sortBy > 3) sortBy = 0;
 					doc_.get_option().set_sort_type(sortBy);
+					doc_.resort();
+					break;
+				case VK_RBUTTON:
+					doc_.get_option().set_sort_order(!doc_.get_option().get_sort_order());
+					doc_.resort();
+					break;
+				case VK_MBUTTON:
+					doc_.get_option().set_show_hidden(!doc_.get_option().is_show_hidden());
+					doc_.Update();
 					break;
-				case VK_RBUTTON: doc_.get_option().set_sort_order(!doc_.get_option().get_sort_order()); break;
-				case VK_MBUTTON: doc_.get_option().set_show_hidden(!doc_.get_option().is_show_hidden()); break;
 				default: break;
 				}
-				ht_.set_index(0U);
-				doc_.Update();
 			}
 		}
 		return true;
@@ -776,10 +811,23 @@ public:
 				}
 			}
 		} else {
+			if (key == VK_F3 && window_utils::shift_pressed()) {
+				search_subtree();  // Search below the current folder
+				return;
+			}
 			if (key == VK_F3) {
 				set_cursor_index(search_.find_next(list_cursor_idx_, doc_.get_files()), Document::ListType::FILE);
 				return;
 			}
+			if (key == VK_ESCAPE && doc_.in_subtree_search()) {
+				search_.clear_filter();
+				doc_.Update();  // Back to the folder
+				return;
+			}
+			if (search_.is_filter_mode() && (key == VK_BACK || key == VK_ESCAPE || (_T('A') <= key && key <= _T('Z')))) {
+				filter_files(key);  // Key input filter
+				return;
+			}
 			key_cursor(key);  // Cursor movement by key operation
 			if (_T('A') <= key && key <= _T('Z')) {
 				search_.key_search(gsl::narrow<wchar_t>(key));  // Key input search
@@ -787,6 +835,39 @@ public:
 		}
 	}
 
+	// Search the files below the current folder by the word typed so far; searched again when the word changes
+	void search_subtree() {
+		if (!search_.prepare()) return;
+		doc_.search_subtree([this](Matcher& m) { search_.compile_into(m); });
+	}
+
+	// Narrow the file list on every key input, and widen it by backspace or escape
+	void filter_files(WPARAM key) {
+		if (doc_.in_subtree_search()) {
+			if (key != VK_BACK) search_.filter_key(gsl::narrow<wchar_t>(key));
+			else if (!search_.filter_back()) return;
+			search_subtree();
+			return;
+		}
+		if (!doc_.get_files().is_filtered()) search_.clear_filter();  // The folder has been changed
+		if (key == VK_ESCAPE || (key == VK_BACK && !search_.filter_back())) {
+			search_.clear_filter();
+			doc_.unfilter_files();
+		} else {
+			const bool literal = search_.is_literal();
+			if (key != VK_BACK) search_.filter_key(gsl::narrow<wchar_t>(key));
+			const bool narrow = key != VK_BACK && literal && search_.is_literal();  // Migemo patterns do not narrow
+			if (search_.is_fuzzy_mode()) {
+				doc_.rank_files([this](const Item& it) { return search_.score(it.name(), it.char_mask()); }, narrow);
+			} else {
+				doc_.filter_files([this](const Item& it) { return search_.match(it.name()); }, narrow);
+			}
+		}
+		set_scroll_list_top_index(0);
+		set_cursor_index(0, Document::ListType::FILE);
+		::InvalidateRect(wnd_, nullptr, TRUE);
+	}
+
 	// Cursor key input
 	void key_cursor(WPARAM key) {
 		std::optional<size_t> idx = list_cursor_idx_;
@@ -877,7 +958,8 @@ public:
 			r.bottom = r.top + cy_item_;
 			::InvalidateRect(wnd_, &r, FALSE);
 		}
-		if (!index.has_value() || (doc_.get_item(type, index.value())->data() & SEPA) != 0) {
+		const size_t size = (type == Document::ListType::FILE) ? doc_.get_files().size() : doc_.get_navi_count();
+		if (!index.has_value() || size <= index.value() || (doc_.get_item(type, index.value()).data() & SEPA) != 0) {
 			list_cursor_idx_.reset();
 			tt_.inactivate();  // Hide tool tip
 			::UpdateWindow(wnd_);
@@ -895,9 +977,9 @@ public:
 		::UpdateWindow(wnd_);  // Update here as curSelIsLong_ is referred below
 		tt_.inactivate();  // Hide tool tip
 		if (is_cur_sel_long_) {  // Show tool tip
-			tt_.activate(doc_.get_item(type, index.value())->name(), list_rect_);
+			tt_.activate(std::wstring{ doc_.get_item(type, index.value()).name() }, list_rect_);
 		} else if (doc_.in_bookmark() || doc_.in_history()) {
-			tt_.activate(doc_.get_item(type, index.value())->path(), list_rect_);
+			tt_.activate(doc_.get_item(type, index.value()).path(), list_rect_);
 		}
 	}
 
@@ -1023,10 +1105,10 @@ public:
 		::UpdateWindow(wnd_);
 	}
 
-	// Display file information
+	// Display file information; the size is updated as it is calculated until the popup is closed
 	void popup_info(Document::ListType w, size_t index) {
 		std::vector<std::wstring> strs;
-		ope_.create_information_strings(strs);
+		const bool sizing = ope_.create_information_strings(strs, doc_.get_item(w, index).time());
 		strs.push_back(_T("...more"));
 		UINT f{};
 
@@ -1036,14 +1118,33 @@ public:
 		for (size_t i = 0; i < strs.size(); ++i) {
 			::AppendMenu(hmenu, MF_STRING, i, strs.at(i).c_str());
 		}
+		if (sizing) {
+			info_menu_ = hmenu;
+			::SetTimer(wnd_, IDT_INFO_SIZE, 100, nullptr);
+		}
 		const POINT pt = get_popup_pt(w, index, f);
 		const int ret  = ::TrackPopupMenu(hmenu, TPM_RETURNCMD | TPM_LEFTBUTTON | f, pt.x, pt.y, 0, wnd_, nullptr);
+		if (sizing) {
+			::KillTimer(wnd_, IDT_INFO_SIZE);
+			info_menu_ = nullptr;
+			ope_.cancel_size_calculation();
+		}
 		::DestroyMenu(hmenu);
 		if (gsl::narrow<size_t>(ret) == strs.size() - 1) {
 			ope_.popup_file_property();
 		}
 	}
 
+	// Show the size calculated so far on the first line of the information popup
+	void update_info_size() {
+		if (!info_menu_) return;
+		std::wstring str;
+		const bool done = ope_.size_string(str);
+		::ModifyMenu(info_menu_, 0, MF_BYPOSITION | MF_STRING, 0, str.c_str());
+		if (auto menu = window_utils::thread_menu_window()) ::InvalidateRect(menu, nullptr, FALSE);  // Not the menus of the others
+		if (done) ::KillTimer(wnd_, IDT_INFO_SIZE);
+	}
+
 	// Find the position of the popup
 	POINT get_popup_pt(Document::ListType w, size_t index, UINT &f) noexcept {
 		f = TPM_RETURNCMD;
@@ -1092,4 +1193,8 @@ public:
 		::UpdateWindow(wnd_);
 	}
 
+	void appended() override {
+		::InvalidateRect(wnd_, nullptr, FALSE);
+	}
+
 };
@@ -2,7 +2,7 @@
  * Window Utilities
  *
  * @author Takuto Yanagida
- * @version 2025-11-21
+ * @version 2026-10-17
  */
 
 #pragma once
@@ -49,6 +49,20 @@ namespace window_utils {
 		::MoveWindow(wnd, x, y, w, h, FALSE);
 	}
 
+	// Window of the popup menu shown by the calling thread (nullptr when none is shown)
+	HWND thread_menu_window() noexcept {
+		HWND ret = nullptr;
+		::EnumThreadWindows(::GetCurrentThreadId(), [](HWND wnd, LPARAM lp) noexcept -> BOOL {
+			TCHAR cn[8]{};
+			::GetClassName(wnd, &cn[0], 8);
+			if (::lstrcmp(&cn[0], _T("#32768")) != 0 || !::IsWindowVisible(wnd)) return TRUE;
+			[[gsl::suppress("type.1")]]
+			*reinterpret_cast<HWND*>(lp) = wnd;
+			return FALSE;
+		}, reinterpret_cast<LPARAM>(&ret));
+		return ret;
+	}
+
 	// Bring the window completely to the front
 	void foreground_window(HWND wnd) noexcept {
 		DWORD t{};
@@ -67,6 +81,10 @@ namespace window_utils {
 		return (::GetAsyncKeyState(VK_CONTROL) & 0x8000) != 0;
 	}
 
+	bool shift_pressed() noexcept {
+		return (::GetAsyncKeyState(VK_SHIFT) & 0x8000) != 0;
+	}
+
 	HFONT get_ui_message_font(HWND wnd) noexcept {
 		NONCLIENTMETRICSW ncm{};
 		ncm.cbSize = sizeof(ncm);